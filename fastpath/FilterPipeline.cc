@@ -0,0 +1,107 @@
+/*
+ * FilterPipeline.cc
+ *
+ *  Created on: May 27, 2024
+ *      Author: pramita
+ */
+
+#include "FilterPipeline.h"
+
+#include <cmath>
+
+uint32_t MersenneTwisterRng::intRand(uint32_t n) {
+    // Same draw sequence as MTRand::randInt(n - 1)
+    uint32_t max = n - 1;
+    uint32_t used = max;
+    used |= used >> 1;
+    used |= used >> 2;
+    used |= used >> 4;
+    used |= used >> 8;
+    used |= used >> 16;
+    uint32_t i;
+    do
+        i = _mt() & used;
+    while (i > max);
+    return i;
+}
+
+void StatSummary::collect(double value) {
+    if (count == 0 || value < min)
+        min = value;
+    if (count == 0 || value > max)
+        max = value;
+    count++;
+    sum += value;
+    sqrsum += value * value;
+}
+
+double StatSummary::getStddev() const {
+    if (count < 2)
+        return NAN;
+    double var = (sqrsum - sum * sum / count) / (count - 1);
+    return var < 0 ? 0 : std::sqrt(var);
+}
+
+void SensorSource::generate(int *samples, int count) {
+    for (int i = 0; i < count; i++)
+        samples[i] = _rng.intuniform(0, _max_value);
+}
+
+bool HubStage::process(int child, double value) {
+    FilterOutcome outcome = _filters.apply(child, value);
+    if (++_num_filtered > _warmup_samples) {
+        _errors.collect(outcome.predictionError);
+        _steady_state.collect(outcome.predictionError);
+    }
+    if (!outcome.forwarded)
+        return false;
+    _num_forwarded++;
+    return true;
+}
+
+int ObnStage::addHub(const FilterSettings& settings) {
+    _filters.push_back(makeFilter(settings));
+    return static_cast<int>(_filters.size()) - 1;
+}
+
+void ObnStage::process(int hub, int value) {
+    _num_received++;
+    int filteredValue = static_cast<int>(_filters[hub].updateEstimate(value));
+    if (isForwarded(filteredValue - value))
+        _num_transmissions++;
+}
+
+FilterPipeline::FilterPipeline(int seedSet, int warmupSamples) : _rng(seedSet) {
+    // Filters from the hub filter configuration of the simulation, value ranges as in node11 ... node32
+    static const struct { const char *name; int maxValue; int hub; } sensors[] = {
+        {"Node_11", 220, 0}, {"Node_12", 220, 0}, {"Node_21", 220, 1},
+        {"Node_22", 200, 1}, {"Node_31", 200, 2}, {"Node_32", 3000, 2},
+    };
+    for (int hub = 0; hub < NUM_HUBS; hub++) {
+        _hubs.push_back(HubStage(hub, warmupSamples));
+        _obn.addHub(getHubFilterConfig(hub).obnFilter);
+    }
+    for (auto& sensor : sensors) {
+        int child = _hubs[sensor.hub].findChild(sensor.name);
+        _children.push_back(Child{SensorSource(sensor.name, sensor.maxValue, _rng), sensor.hub, child});
+    }
+}
+
+void FilterPipeline::run(int numSamples) {
+    // The OBN picks the hub for its "Hello There!" before the sensors start
+    _rng.intuniform(0, static_cast<int>(_hubs.size()) - 1);
+
+    // Sensors send their whole burst at start-up, so the hubs see the samples
+    // of one child after the other, and the OBN those of one hub after the other
+    _block.resize(numSamples);
+    std::vector<std::vector<int>> forwarded(_hubs.size());
+    for (Child& c : _children) {
+        c.source.generate(_block.data(), numSamples);
+        for (int i = 0; i < numSamples; i++)
+            if (_hubs[c.hub].process(c.child, _block[i]))
+                forwarded[c.hub].push_back(_block[i]);
+    }
+    for (size_t hub = 0; hub < forwarded.size(); hub++)
+        for (int value : forwarded[hub])
+            _obn.process(static_cast<int>(hub), value);
+}
@@ -0,0 +1,128 @@
+/*
+ * FilterPipeline.h
+ *
+ *  Created on: May 27, 2024
+ *      Author: pramita
+ */
+
+#ifndef FILTERPIPELINE_H_
+#define FILTERPIPELINE_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/HubFilters.h"
+#include "../src/SteadyStateDetector.h"
+
+// Sensor generation, hub filtering/forwarding and OBN filtering of
+// My_simulation3_network as plain C++ stages, without the OMNeT++ kernel.
+//
+// With the default RNG settings of the simulation (one Mersenne Twister
+// shared by all modules) and the default start-up burst of samples, the
+// pipeline draws the same numbers in the same order as the simulation and
+// therefore reproduces its PredictionError statistics for the same seed set.
+
+// Random numbers as drawn by OMNeT++'s cMersenneTwister
+class MersenneTwisterRng {
+private:
+    std::mt19937 _mt;
+
+public:
+    MersenneTwisterRng(int seedSet = 0, int rngId = 0, int numRngs = 1) : _mt(seedSet * numRngs + rngId) {}
+    uint32_t intRand() { return _mt(); }
+    // Uniform integer in [0, n), with the bit mask rejection of MTRand::randInt()
+    uint32_t intRand(uint32_t n);
+    // Equivalent of cComponent::intuniform(a, b)
+    int intuniform(int a, int b) { return a + static_cast<int>(intRand(b - a + 1)); }
+};
+
+// Streaming summary with the fields recorded for a cHistogram/cStdDev
+struct StatSummary {
+    long count = 0;
+    double sum = 0;
+    double sqrsum = 0;
+    double min = 0;
+    double max = 0;
+
+    void collect(double value);
+    double getMean() const { return count > 0 ? sum / count : 0; }
+    double getStddev() const;
+};
+
+class SensorSource {
+private:
+    std::string _name;
+    int _max_value;
+    MersenneTwisterRng& _rng;
+
+public:
+    SensorSource(const std::string& name, int maxValue, MersenneTwisterRng& rng)
+        : _name(name), _max_value(maxValue), _rng(rng) {}
+    const std::string& getName() const { return _name; }
+    // Fills the block with the next samples of this sensor
+    void generate(int *samples, int count);
+};
+
+class HubStage {
+private:
+    HubFilters _filters; // The same child filters as Hub_node1/2/3
+    int _warmup_samples;
+    long _num_filtered = 0;
+    long _num_forwarded = 0;
+    StatSummary _errors;
+    SteadyStateDetector _steady_state;
+
+public:
+    HubStage(int hub, int warmupSamples) : _filters(hub), _warmup_samples(warmupSamples) {}
+    std::string getName() const { return _filters.getConfig().hubName; }
+    // Index of the child with the given sensor name, -1 if it is not one of this hub's children
+    int findChild(const char *sensorName) const { return _filters.findChild(sensorName); }
+
+    // Filters one sample of the given child; returns true if it is forwarded to the OBN
+    bool process(int child, double value);
+
+    long getNumForwarded() const { return _num_forwarded; }
+    const StatSummary& getPredictionErrors() const { return _errors; }
+    const SteadyStateDetector& getSteadyState() const { return _steady_state; }
+};
+
+class ObnStage {
+private:
+    std::vector<SimpleKalmanFilter> _filters; // One per hub
+    long _num_received = 0;
+    long _num_transmissions = 0;
+
+public:
+    int addHub(const FilterSettings& settings);
+    void process(int hub, int value);
+    long getNumReceived() const { return _num_received; }
+    long getNumTransmissions() const { return _num_transmissions; }
+};
+
+// The network of My_simulation3_network: OBN, three hubs, two sensors per hub
+class FilterPipeline {
+private:
+    struct Child {
+        SensorSource source;
+        int hub;
+        int child;
+    };
+    MersenneTwisterRng _rng;
+    std::vector<Child> _children;
+    std::vector<HubStage> _hubs;
+    ObnStage _obn;
+    std::vector<int> _block;
+
+public:
+    FilterPipeline(int seedSet, int warmupSamples);
+    FilterPipeline(const FilterPipeline&) = delete; // Sensor sources refer to _rng
+    // Generates numSamples samples per sensor and runs them through the hubs and the OBN
+    void run(int numSamples);
+
+    const std::vector<HubStage>& getHubs() const { return _hubs; }
+    const ObnStage& getObn() const { return _obn; }
+};
+
+#endif /* FILTERPIPELINE_H_ */
@@ -0,0 +1,61 @@
+/*
+ * filterbench.cc
+ *
+ *  Created on: May 27, 2024
+ *      Author: pramita
+ */
+
+// Runs the filter pipeline of My_simulation3_network without the simulation
+// kernel and prints the hub PredictionError statistics in the scalar format
+// of the simulation's .sca files, one run per seed set.
+//
+// usage: filterbench [-r firstSeedSet] [-c numRuns] [-n samplesPerSensor] [-w warmupSamples]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+
+#include "FilterPipeline.h"
+
+static void printResults(const FilterPipeline& pipeline, int seedSet) {
+    const char *network = "My_simulation3_network";
+    printf("run filterbench-%d\n", seedSet);
+    for (const HubStage& hub : pipeline.getHubs()) {
+        const StatSummary& errors = hub.getPredictionErrors();
+        printf("statistic %s.%s PredictionError\n", network, hub.getName().c_str());
+        printf("field count %ld\nfield mean %.17g\nfield stddev %.17g\nfield min %.17g\nfield max %.17g\nfield sum %.17g\nfield sqrsum %.17g\n",
+               errors.count, errors.getMean(), errors.getStddev(), errors.min, errors.max, errors.sum, errors.sqrsum);
+        printf("scalar %s.%s samplesForwarded %ld\n", network, hub.getName().c_str(), hub.getNumForwarded());
+        printf("scalar %s.%s mserTruncationPoint %ld\n", network, hub.getName().c_str(), hub.getSteadyState().getTruncationPoint());
+        printf("scalar %s.%s steadyStatePredictionError %.17g\n", network, hub.getName().c_str(), hub.getSteadyState().getSteadyStateMean());
+    }
+    printf("scalar %s.OBN samplesReceived %ld\n", network, pipeline.getObn().getNumReceived());
+    printf("scalar %s.OBN transmissions %ld\n", network, pipeline.getObn().getNumTransmissions());
+}
+
+int main(int argc, char **argv) {
+    int firstSeedSet = 0, numRuns = 1, numSamples = 100, warmupSamples = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "r:c:n:w:h")) != -1) {
+        switch (opt) {
+            case 'r': firstSeedSet = atoi(optarg); break;
+            case 'c': numRuns = atoi(optarg); break;
+            case 'n': numSamples = atoi(optarg); break;
+            case 'w': warmupSamples = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-r firstSeedSet] [-c numRuns] [-n samplesPerSensor] [-w warmupSamples]\n", argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int seedSet = firstSeedSet; seedSet < firstSeedSet + numRuns; seedSet++) {
+        FilterPipeline pipeline(seedSet, warmupSamples);
+        pipeline.run(numSamples);
+        printResults(pipeline, seedSet);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%d runs of %d samples per sensor in %.3fs\n", numRuns, numSamples, elapsed);
+    return 0;
+}
@@ -0,0 +1,306 @@
+/*
+ * ResultReader.cc
+ *
+ *  Created on: Jul 8, 2024
+ *      Author: pramita
+ */
+
+#include "ResultReader.h"
+
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <stdexcept>
+
+// Splits a line into whitespace separated tokens; "quoted" tokens may contain
+// spaces and backslash escapes
+static std::vector<std::string> tokenize(const char *p, const char *end) {
+    std::vector<std::string> tokens;
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+        if (p == end)
+            break;
+        std::string token;
+        if (*p == '"') {
+            for (p++; p < end && *p != '"'; p++) {
+                if (*p == '\\' && p + 1 < end)
+                    p++;
+                token += *p;
+            }
+            p++;
+        } else {
+            while (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+                token += *p++;
+        }
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+// Parses the next whitespace separated number; p is advanced past it
+static bool parseNumber(const char *& p, const char *end, double& value) {
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+    char buf[64];
+    size_t n = 0;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && n < sizeof(buf) - 1)
+        buf[n++] = *p++;
+    if (n == 0)
+        return false;
+    buf[n] = '\0';
+    char *parsed;
+    value = strtod(buf, &parsed);
+    return parsed == buf + n;
+}
+
+// Skips the next whitespace separated token; returns false if there is none
+static bool skipToken(const char *& p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+    const char *start = p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+        p++;
+    return p != start;
+}
+
+static bool isDataLine(const char *p) {
+    return *p >= '0' && *p <= '9';
+}
+
+static const char *nextLine(const char *p, const char *end, const char *& eol) {
+    eol = static_cast<const char *>(memchr(p, '\n', end - p));
+    if (eol == nullptr)
+        eol = end;
+    return eol + 1;
+}
+
+// Header lines shared by all result files; returns false if the line is not one of them
+static bool parseRunLine(const std::vector<std::string>& tokens, RunInfo& run) {
+    const std::string& keyword = tokens[0];
+    if (keyword == "run" && tokens.size() >= 2)
+        run.runId = tokens[1];
+    else if (keyword == "attr" && tokens.size() >= 3)
+        run.attributes[tokens[1]] = tokens[2];
+    else if (keyword == "itervar" && tokens.size() >= 3)
+        run.itervars[tokens[1]] = tokens[2];
+    else if (keyword != "version" && keyword != "config" && keyword != "param" && keyword != "par")
+        return false;
+    return true;
+}
+
+static bool matches(const std::string& pattern, const std::string& text) {
+    return pattern.empty() || fnmatch(pattern.c_str(), text.c_str(), 0) == 0;
+}
+
+std::string RunInfo::getAttribute(const std::string& name) const {
+    auto it = attributes.find(name);
+    return it != attributes.end() ? it->second : std::string();
+}
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open " + path + ": " + strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat " + path + ": " + strerror(errno));
+    }
+    _size = st.st_size;
+    if (_size > 0) {
+        void *data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Cannot map " + path + ": " + strerror(errno));
+        }
+        madvise(data, _size, MADV_SEQUENTIAL);
+        _data = static_cast<const char *>(data);
+    }
+    close(fd); // The mapping stays valid
+}
+
+MappedFile::~MappedFile() {
+    if (_data != nullptr)
+        munmap(const_cast<char *>(_data), _size);
+}
+
+VectorFile::VectorFile(const std::string& path) : _path(path), _file(path) {
+    std::string vciPath = path;
+    if (vciPath.size() > 4 && vciPath.compare(vciPath.size() - 4, 4, ".vec") == 0)
+        vciPath.replace(vciPath.size() - 4, 4, ".vci");
+    else
+        vciPath += ".vci";
+    if (access(vciPath.c_str(), R_OK) == 0 && readIndexFile(vciPath)) {
+        _indexed_from_vci = true;
+        return;
+    }
+    _run = RunInfo();
+    _vectors.clear();
+    _index_of.clear();
+    scan();
+}
+
+VectorInfo& VectorFile::getVectorById(int id) {
+    auto it = _index_of.find(id);
+    if (it == _index_of.end())
+        throw std::runtime_error(_path + ": data of undeclared vector " + std::to_string(id));
+    return _vectors[it->second];
+}
+
+// Header lines of .vec and .vci files; after the first vector declaration
+// attr lines belong to the vector and are skipped
+static void parseVectorHeaderLine(const std::vector<std::string>& tokens, RunInfo& run, std::vector<VectorInfo>& vectors,
+                                  std::map<int, size_t>& indexOf, const std::string& path) {
+    if (tokens[0] == "vector") {
+        if (tokens.size() < 4)
+            throw std::runtime_error(path + ": malformed vector declaration");
+        VectorInfo vector;
+        vector.id = atoi(tokens[1].c_str());
+        vector.module = tokens[2];
+        vector.name = tokens[3];
+        if (tokens.size() >= 5)
+            vector.columns = tokens[4];
+        indexOf[vector.id] = vectors.size();
+        vectors.push_back(vector);
+    } else if (vectors.empty()) {
+        parseRunLine(tokens, run);
+    }
+}
+
+bool VectorFile::readIndexFile(const std::string& vciPath) {
+    MappedFile index(vciPath);
+    const char *p = index.data(), *end = p + index.size(), *eol;
+    if (p == nullptr)
+        return false;
+
+    // "file <size> <mtime>": an index of another version of the .vec file is ignored
+    const char *next = nextLine(p, end, eol);
+    std::vector<std::string> tokens = tokenize(p, eol);
+    if (tokens.size() < 2 || tokens[0] != "file" || strtoull(tokens[1].c_str(), nullptr, 10) != _file.size())
+        return false;
+
+    for (p = next; p < end; p = next) {
+        next = nextLine(p, end, eol);
+        if (p == eol)
+            continue;
+        if (isDataLine(p)) {
+            // id offset length firstEvent lastEvent firstTime lastTime count min max sum sqrsum
+            double fields[8];
+            for (int i = 0; i < 8; i++)
+                if (!parseNumber(p, eol, fields[i]))
+                    return false;
+            // A stale or foreign index may name vectors the header does not declare
+            auto it = _index_of.find(static_cast<int>(fields[0]));
+            if (it == _index_of.end())
+                return false;
+            VectorInfo& vector = _vectors[it->second];
+            VectorBlock block = {static_cast<size_t>(fields[1]), static_cast<size_t>(fields[2]), static_cast<long>(fields[7])};
+            if (block.offset + block.length > _file.size())
+                return false;
+            vector.blocks.push_back(block);
+            vector.count += block.count;
+        } else {
+            parseVectorHeaderLine(tokenize(p, eol), _run, _vectors, _index_of, vciPath);
+        }
+    }
+    return true;
+}
+
+void VectorFile::scan() {
+    const char *begin = _file.data(), *end = begin + _file.size(), *eol;
+    VectorInfo *last = nullptr;
+    for (const char *p = begin, *next; p < end; p = next) {
+        next = nextLine(p, end, eol);
+        if (p == eol)
+            continue;
+        if (isDataLine(p)) {
+            int id = 0;
+            for (const char *digit = p; digit < eol && *digit >= '0' && *digit <= '9'; digit++)
+                id = id * 10 + (*digit - '0');
+            if (last == nullptr || last->id != id)
+                last = &getVectorById(id);
+            size_t offset = p - begin;
+            // Consecutive lines of the same vector extend its last block
+            if (last->blocks.empty() || last->blocks.back().offset + last->blocks.back().length != offset)
+                last->blocks.push_back(VectorBlock{offset, 0, 0});
+            last->blocks.back().length = next - begin - last->blocks.back().offset;
+            last->blocks.back().count++;
+            last->count++;
+        } else {
+            parseVectorHeaderLine(tokenize(p, eol), _run, _vectors, _index_of, _path);
+            last = nullptr; // _vectors may have been reallocated
+        }
+    }
+}
+
+bool VectorFile::parseLine(const char *p, const char *end, const std::string& columns, double& time, double& value) {
+    if (!skipToken(p, end)) // Vector id
+        return false;
+    time = 0;
+    for (char column : columns) {
+        bool parsed = column == 'T' ? parseNumber(p, end, time) : column == 'V' ? parseNumber(p, end, value) : skipToken(p, end);
+        if (!parsed)
+            return false;
+    }
+    return true;
+}
+
+std::vector<const VectorInfo *> VectorFile::findVectors(const std::string& modulePattern, const std::string& namePattern) const {
+    std::vector<const VectorInfo *> result;
+    for (const VectorInfo& vector : _vectors)
+        if (matches(modulePattern, vector.module) && matches(namePattern, vector.name))
+            result.push_back(&vector);
+    return result;
+}
+
+ScalarFile::ScalarFile(const std::string& path) : _path(path) {
+    MappedFile file(path);
+    const char *p = file.data(), *end = p + file.size(), *eol;
+    bool inRunHeader = true; // attr lines after the first result belong to that result
+    for (const char *next; p < end; p = next) {
+        next = nextLine(p, end, eol);
+        std::vector<std::string> tokens = tokenize(p, eol);
+        if (tokens.empty())
+            continue;
+        const std::string& keyword = tokens[0];
+        if (keyword == "scalar") {
+            if (tokens.size() < 4)
+                throw std::runtime_error(path + ": malformed scalar line");
+            _scalars.push_back(ScalarResult{tokens[1], tokens[2], strtod(tokens[3].c_str(), nullptr)});
+            inRunHeader = false;
+        } else if (keyword == "statistic") {
+            if (tokens.size() < 3)
+                throw std::runtime_error(path + ": malformed statistic line");
+            _statistics.push_back(StatisticResult{tokens[1], tokens[2], {}});
+            inRunHeader = false;
+        } else if (keyword == "field") {
+            if (_statistics.empty() || tokens.size() < 3)
+                throw std::runtime_error(path + ": field line outside a statistic");
+            _statistics.back().fields[tokens[1]] = strtod(tokens[2].c_str(), nullptr);
+        } else if (keyword == "par") {
+            inRunHeader = false; // Recorded parameter values, followed by their own attr lines
+        } else if (inRunHeader) {
+            parseRunLine(tokens, _run);
+        }
+    }
+}
+
+std::vector<const ScalarResult *> ScalarFile::findScalars(const std::string& modulePattern, const std::string& namePattern) const {
+    std::vector<const ScalarResult *> result;
+    for (const ScalarResult& scalar : _scalars)
+        if (matches(modulePattern, scalar.module) && matches(namePattern, scalar.name))
+            result.push_back(&scalar);
+    return result;
+}
+
+std::vector<const StatisticResult *> ScalarFile::findStatistics(const std::string& modulePattern, const std::string& namePattern) const {
+    std::vector<const StatisticResult *> result;
+    for (const StatisticResult& statistic : _statistics)
+        if (matches(modulePattern, statistic.module) && matches(namePattern, statistic.name))
+            result.push_back(&statistic);
+    return result;
+}
@@ -0,0 +1,153 @@
+/*
+ * ResultReader.h
+ *
+ *  Created on: Jul 8, 2024
+ *      Author: pramita
+ */
+
+#ifndef RESULTREADER_H_
+#define RESULTREADER_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Readers for the text result files of OMNeT++ (version 3 of the .vec/.sca
+// format). Files are memory-mapped and parsed in place: opening a vector file
+// only builds an index of where each vector's lines are, and the values are
+// parsed while they are streamed to the caller, so memory does not grow with
+// the size of the file. All parse errors throw std::runtime_error.
+
+// Run attributes from the header of a result file
+struct RunInfo {
+    std::string runId;
+    std::map<std::string, std::string> attributes; // attr lines, quotes removed
+    std::map<std::string, std::string> itervars;   // itervar lines
+
+    std::string getAttribute(const std::string& name) const;
+    std::string getConfigName() const { return getAttribute("configname"); }
+    std::string getIterationVars() const { return getAttribute("iterationvars"); }
+    int getRepetition() const { return atoi(getAttribute("repetition").c_str()); }
+};
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+private:
+    const char *_data = nullptr;
+    size_t _size = 0;
+
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char *data() const { return _data; }
+    size_t size() const { return _size; }
+};
+
+// Contiguous lines of one vector in the .vec file
+struct VectorBlock {
+    size_t offset;
+    size_t length;
+    long count;
+};
+
+struct VectorInfo {
+    int id;
+    std::string module;
+    std::string name;
+    std::string columns = "ETV"; // E = event number, T = time, V = value
+    std::vector<VectorBlock> blocks;
+    long count = 0;
+};
+
+class VectorFile {
+private:
+    std::string _path;
+    MappedFile _file;
+    RunInfo _run;
+    std::vector<VectorInfo> _vectors;
+    std::map<int, size_t> _index_of; // Vector id -> position in _vectors
+    bool _indexed_from_vci = false;
+
+    VectorInfo& getVectorById(int id);
+    bool readIndexFile(const std::string& vciPath);
+    void scan();
+
+    // Parses one data line in place; returns false for a malformed line
+    static bool parseLine(const char *p, const char *end, const std::string& columns, double& time, double& value);
+
+public:
+    // Uses the .vci index next to the file when it is up to date, otherwise
+    // indexes the vectors with one scan over the mapped file
+    explicit VectorFile(const std::string& path);
+
+    const std::string& getPath() const { return _path; }
+    const RunInfo& getRun() const { return _run; }
+    const std::vector<VectorInfo>& getVectors() const { return _vectors; }
+    bool isIndexedFromVci() const { return _indexed_from_vci; }
+
+    // Vectors whose module and name match the glob patterns
+    std::vector<const VectorInfo *> findVectors(const std::string& modulePattern, const std::string& namePattern) const;
+
+    // Calls visit(time, value) for every value of the vector, in file order;
+    // throws on a malformed data line
+    template <class Visitor>
+    void forEachValue(const VectorInfo& vector, Visitor visit) const {
+        for (const VectorBlock& block : vector.blocks) {
+            const char *p = _file.data() + block.offset;
+            const char *end = p + block.length;
+            while (p < end) {
+                const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+                if (eol == nullptr)
+                    eol = end;
+                double time, value;
+                if (p != eol) {
+                    if (!parseLine(p, eol, vector.columns, time, value))
+                        throw std::runtime_error(_path + ": malformed data line at offset " + std::to_string(p - _file.data()));
+                    visit(time, value);
+                }
+                p = eol + 1;
+            }
+        }
+    }
+};
+
+struct ScalarResult {
+    std::string module;
+    std::string name;
+    double value;
+};
+
+// Summary of a cStdDev/cHistogram as recorded with "statistic" and "field" lines
+struct StatisticResult {
+    std::string module;
+    std::string name;
+    std::map<std::string, double> fields; // count, mean, stddev, min, max, sum, sqrsum
+};
+
+class ScalarFile {
+private:
+    std::string _path;
+    RunInfo _run;
+    std::vector<ScalarResult> _scalars;
+    std::vector<StatisticResult> _statistics;
+
+public:
+    explicit ScalarFile(const std::string& path);
+
+    const std::string& getPath() const { return _path; }
+    const RunInfo& getRun() const { return _run; }
+    const std::vector<ScalarResult>& getScalars() const { return _scalars; }
+    const std::vector<StatisticResult>& getStatistics() const { return _statistics; }
+
+    std::vector<const ScalarResult *> findScalars(const std::string& modulePattern, const std::string& namePattern) const;
+    std::vector<const StatisticResult *> findStatistics(const std::string& modulePattern, const std::string& namePattern) const;
+};
+
+#endif /* RESULTREADER_H_ */
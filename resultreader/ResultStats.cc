@@ -0,0 +1,141 @@
+/*
+ * ResultStats.cc
+ *
+ *  Created on: Jul 8, 2024
+ *      Author: pramita
+ */
+
+#include "ResultStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+P2Quantile::P2Quantile(double p) : _p(p) {
+    for (int i = 0; i < 5; i++)
+        _positions[i] = i + 1;
+    _desired[0] = 1;
+    _desired[1] = 1 + 2 * p;
+    _desired[2] = 1 + 4 * p;
+    _desired[3] = 3 + 2 * p;
+    _desired[4] = 5;
+    _increments[0] = 0;
+    _increments[1] = p / 2;
+    _increments[2] = p;
+    _increments[3] = (1 + p) / 2;
+    _increments[4] = 1;
+}
+
+double P2Quantile::parabolic(int i, int d) const {
+    const double *q = _heights, *n = _positions;
+    return q[i] + d / (n[i + 1] - n[i - 1]) *
+           ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+            (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+double P2Quantile::linear(int i, int d) const {
+    return _heights[i] + d * (_heights[i + d] - _heights[i]) / (_positions[i + d] - _positions[i]);
+}
+
+void P2Quantile::collect(double value) {
+    if (_count < 5) {
+        _heights[_count++] = value;
+        if (_count == 5)
+            std::sort(_heights, _heights + 5);
+        return;
+    }
+    _count++;
+
+    // Cell of the new value; the extreme markers follow the min and max
+    int k;
+    if (value < _heights[0]) {
+        _heights[0] = value;
+        k = 0;
+    } else if (value >= _heights[4]) {
+        _heights[4] = value;
+        k = 3;
+    } else {
+        k = 0;
+        while (value >= _heights[k + 1])
+            k++;
+    }
+    for (int i = k + 1; i < 5; i++)
+        _positions[i]++;
+    for (int i = 0; i < 5; i++)
+        _desired[i] += _increments[i];
+
+    // Move the middle markers towards their desired positions
+    for (int i = 1; i < 4; i++) {
+        double d = _desired[i] - _positions[i];
+        if ((d >= 1 && _positions[i + 1] - _positions[i] > 1) || (d <= -1 && _positions[i - 1] - _positions[i] < -1)) {
+            int step = d > 0 ? 1 : -1;
+            double height = parabolic(i, step);
+            if (_heights[i - 1] < height && height < _heights[i + 1])
+                _heights[i] = height;
+            else
+                _heights[i] = linear(i, step);
+            _positions[i] += step;
+        }
+    }
+}
+
+double P2Quantile::get() const {
+    if (_count == 0)
+        return NAN;
+    if (_count > 5)
+        return _heights[2];
+    // Up to five values: interpolate between the sorted values
+    double sorted[5];
+    for (int i = 0; i < _count; i++) {
+        int j = i;
+        for (; j > 0 && sorted[j - 1] > _heights[i]; j--)
+            sorted[j] = sorted[j - 1];
+        sorted[j] = _heights[i];
+    }
+    double rank = _p * (_count - 1);
+    int lower = static_cast<int>(rank);
+    if (lower + 1 >= _count)
+        return sorted[_count - 1];
+    return sorted[lower] + (rank - lower) * (sorted[lower + 1] - sorted[lower]);
+}
+
+ValueSummary::ValueSummary(const std::vector<double>& probabilities) {
+    for (double p : probabilities)
+        _quantiles.push_back(P2Quantile(p));
+}
+
+void ValueSummary::collect(double value) {
+    if (_count == 0 || value < _min)
+        _min = value;
+    if (_count == 0 || value > _max)
+        _max = value;
+    _count++;
+    _sum += value;
+    _sqrsum += value * value;
+    for (P2Quantile& quantile : _quantiles)
+        quantile.collect(value);
+}
+
+double ValueSummary::getMean() const {
+    return _count > 0 ? _sum / _count : NAN;
+}
+
+double ValueSummary::getStddev() const {
+    if (_count < 2)
+        return NAN;
+    double var = (_sqrsum - _sum * _sum / _count) / (_count - 1);
+    return var < 0 ? 0 : std::sqrt(var);
+}
+
+double ValueSummary::getConfidenceHalfWidth() const {
+    // Two-sided 97.5% quantiles of Student's t distribution for 1..30 degrees of freedom
+    static const double t975[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    if (_count < 2)
+        return NAN;
+    long df = _count - 1;
+    double t = df <= 30 ? t975[df - 1] : 1.96;
+    return t * getStddev() / std::sqrt(static_cast<double>(_count));
+}
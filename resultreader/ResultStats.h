@@ -0,0 +1,60 @@
+/*
+ * ResultStats.h
+ *
+ *  Created on: Jul 8, 2024
+ *      Author: pramita
+ */
+
+#ifndef RESULTSTATS_H_
+#define RESULTSTATS_H_
+
+#include <vector>
+
+// Streaming estimate of one quantile with the P-square algorithm (Jain and
+// Chlamtac, 1985): five markers, O(1) memory and time per value. Exact for
+// up to five values.
+class P2Quantile {
+private:
+    double _p;
+    double _heights[5];
+    double _positions[5];
+    double _desired[5];
+    double _increments[5];
+    long _count = 0;
+
+    double parabolic(int i, int d) const;
+    double linear(int i, int d) const;
+
+public:
+    explicit P2Quantile(double p);
+    void collect(double value);
+    double getProbability() const { return _p; }
+    double get() const;
+};
+
+// Count, mean, standard deviation, min, max and the requested quantiles of a stream of values
+class ValueSummary {
+private:
+    long _count = 0;
+    double _sum = 0;
+    double _sqrsum = 0;
+    double _min = 0;
+    double _max = 0;
+    std::vector<P2Quantile> _quantiles;
+
+public:
+    explicit ValueSummary(const std::vector<double>& probabilities = std::vector<double>());
+    void collect(double value);
+
+    long getCount() const { return _count; }
+    double getMean() const;
+    double getStddev() const;
+    double getMin() const { return _min; }
+    double getMax() const { return _max; }
+    // Half width of the 95% confidence interval of the mean (Student t)
+    double getConfidenceHalfWidth() const;
+    int getNumQuantiles() const { return static_cast<int>(_quantiles.size()); }
+    const P2Quantile& getQuantile(int i) const { return _quantiles[i]; }
+};
+
+#endif /* RESULTSTATS_H_ */
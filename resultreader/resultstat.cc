@@ -0,0 +1,211 @@
+/*
+ * resultstat.cc
+ *
+ *  Created on: Jul 8, 2024
+ *      Author: pramita
+ */
+
+// Summarises the vectors and scalars of OMNeT++ result files as CSV, one
+// line per run and result, or with -a one line per configuration, iteration
+// and result, aggregated over the repetitions (e.g. the iterations of
+// varyRAPlength). Files are read in parallel, one task per file.
+//
+// usage: resultstat [-m modulePattern] [-n namePattern] [-q quantiles] [-j threads] [-a] file.vec|file.sca...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "ResultReader.h"
+#include "ResultStats.h"
+#include "../src/WorkStealingPool.h"
+
+struct ResultRow {
+    std::string runId;
+    std::string config;
+    std::string iterationVars;
+    int repetition;
+    std::string module;
+    std::string name;
+    const char *type;
+    long count;
+    double mean, stddev, min, max;
+    std::vector<double> quantiles;
+};
+
+struct FileResults {
+    std::vector<ResultRow> rows;
+    std::string error;
+    long numValues = 0;
+};
+
+static ResultRow makeRow(const RunInfo& run, const std::string& module, const std::string& name, const char *type) {
+    ResultRow row;
+    row.runId = run.runId;
+    row.config = run.getConfigName();
+    row.iterationVars = run.getIterationVars();
+    row.repetition = run.getRepetition();
+    row.module = module;
+    row.name = name;
+    row.type = type;
+    return row;
+}
+
+static bool endsWith(const std::string& s, const char *suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+static void summariseFile(const std::string& path, const std::string& modulePattern, const std::string& namePattern,
+                          const std::vector<double>& probabilities, FileResults& results) {
+    if (endsWith(path, ".vec")) {
+        VectorFile file(path);
+        for (const VectorInfo *vector : file.findVectors(modulePattern, namePattern)) {
+            ValueSummary summary(probabilities);
+            file.forEachValue(*vector, [&summary](double, double value) { summary.collect(value); });
+            ResultRow row = makeRow(file.getRun(), vector->module, vector->name, "vector");
+            row.count = summary.getCount();
+            row.mean = summary.getMean();
+            row.stddev = summary.getStddev();
+            row.min = summary.getMin();
+            row.max = summary.getMax();
+            for (int i = 0; i < summary.getNumQuantiles(); i++)
+                row.quantiles.push_back(summary.getQuantile(i).get());
+            results.numValues += row.count;
+            results.rows.push_back(row);
+        }
+    } else if (endsWith(path, ".sca")) {
+        ScalarFile file(path);
+        for (const ScalarResult *scalar : file.findScalars(modulePattern, namePattern)) {
+            ResultRow row = makeRow(file.getRun(), scalar->module, scalar->name, "scalar");
+            row.count = 1;
+            row.mean = row.min = row.max = scalar->value;
+            row.stddev = NAN;
+            row.quantiles.assign(probabilities.size(), scalar->value);
+            results.rows.push_back(row);
+        }
+        for (const StatisticResult *statistic : file.findStatistics(modulePattern, namePattern)) {
+            auto field = [statistic](const char *name) {
+                auto it = statistic->fields.find(name);
+                return it != statistic->fields.end() ? it->second : NAN;
+            };
+            ResultRow row = makeRow(file.getRun(), statistic->module, statistic->name, "statistic");
+            row.count = static_cast<long>(field("count"));
+            row.mean = field("mean");
+            row.stddev = field("stddev");
+            row.min = field("min");
+            row.max = field("max");
+            row.quantiles.assign(probabilities.size(), NAN); // Only the bins are recorded
+            results.rows.push_back(row);
+        }
+    } else {
+        throw std::runtime_error("not a .vec or .sca file");
+    }
+}
+
+static std::string csv(const std::string& s) {
+    if (s.find_first_of(",\"") == std::string::npos)
+        return s;
+    std::string quoted = "\"";
+    for (char c : s)
+        quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+    return quoted + "\"";
+}
+
+int main(int argc, char **argv) {
+    std::string modulePattern, namePattern;
+    std::vector<double> probabilities = {0.5, 0.95, 0.99};
+    int numThreads = 0;
+    bool aggregate = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:n:q:j:ah")) != -1) {
+        switch (opt) {
+            case 'm': modulePattern = optarg; break;
+            case 'n': namePattern = optarg; break;
+            case 'q':
+                probabilities.clear();
+                for (char *p = optarg; *p != '\0'; p += *p == ',')
+                    probabilities.push_back(strtod(p, &p));
+                break;
+            case 'j': numThreads = atoi(optarg); break;
+            case 'a': aggregate = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-m modulePattern] [-n namePattern] [-q quantiles] [-j threads] [-a] file.vec|file.sca...\n", argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    std::vector<std::string> paths(argv + optind, argv + argc);
+    if (paths.empty()) {
+        fprintf(stderr, "%s: no result files given\n", argv[0]);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<FileResults> results(paths.size());
+    WorkStealingPool pool(numThreads);
+    std::vector<WorkStealingPool::Task> tasks;
+    for (size_t i = 0; i < paths.size(); i++) {
+        tasks.push_back([&, i]() {
+            try {
+                summariseFile(paths[i], modulePattern, namePattern, probabilities, results[i]);
+            } catch (const std::exception& e) {
+                results[i].error = e.what();
+            }
+        });
+    }
+    pool.run(tasks);
+
+    // Output in the order of the arguments, independent of the thread schedule
+    int status = 0;
+    long numValues = 0;
+    for (size_t i = 0; i < paths.size(); i++) {
+        numValues += results[i].numValues;
+        if (!results[i].error.empty()) {
+            fprintf(stderr, "%s: %s\n", paths[i].c_str(), results[i].error.c_str());
+            status = 1;
+        }
+    }
+
+    if (!aggregate) {
+        printf("run,config,iterationvars,repetition,module,name,type,count,mean,stddev,min,max");
+        for (double p : probabilities)
+            printf(",p%g", p * 100);
+        printf("\n");
+        for (const FileResults& file : results) {
+            for (const ResultRow& row : file.rows) {
+                printf("%s,%s,%s,%d,%s,%s,%s,%ld,%.17g,%.17g,%.17g,%.17g", csv(row.runId).c_str(), csv(row.config).c_str(),
+                       csv(row.iterationVars).c_str(), row.repetition, csv(row.module).c_str(), csv(row.name).c_str(),
+                       row.type, row.count, row.mean, row.stddev, row.min, row.max);
+                for (double q : row.quantiles)
+                    printf(",%.17g", q);
+                printf("\n");
+            }
+        }
+    } else {
+        // Per-run means of the same result, configuration and iteration, over the repetitions
+        typedef std::tuple<std::string, std::string, std::string, std::string, std::string> Key;
+        std::map<Key, ValueSummary> groups;
+        for (const FileResults& file : results)
+            for (const ResultRow& row : file.rows)
+                groups[Key(row.config, row.iterationVars, row.module, row.name, row.type)].collect(row.mean);
+        printf("config,iterationvars,module,name,type,runs,mean,stddev,ci95,min,max\n");
+        for (const auto& group : groups) {
+            const ValueSummary& runs = group.second;
+            printf("%s,%s,%s,%s,%s,%ld,%.17g,%.17g,%.17g,%.17g,%.17g\n", csv(std::get<0>(group.first)).c_str(),
+                   csv(std::get<1>(group.first)).c_str(), csv(std::get<2>(group.first)).c_str(),
+                   csv(std::get<3>(group.first)).c_str(), std::get<4>(group.first).c_str(), runs.getCount(),
+                   runs.getMean(), runs.getStddev(), runs.getConfidenceHalfWidth(), runs.getMin(), runs.getMax());
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%zu files, %ld vector values in %.3fs on %d threads\n", paths.size(), numValues, elapsed, pool.getNumThreads());
+    return status;
+}
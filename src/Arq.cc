@@ -0,0 +1,150 @@
+/*
+ * Arq.cc
+ *
+ *  Created on: Jun 24, 2024
+ *      Author: pramita
+ */
+
+#include "Arq.h"
+#include "Checkpoint.h"
+
+using namespace omnetpp;
+
+ArqSender::~ArqSender()
+{
+    for (Entry& entry : _buffer)
+        delete entry.frame;
+}
+
+void ArqSender::configure(int capacity, double timeout, int maxTries)
+{
+    _capacity = capacity;
+    _timeout = timeout;
+    _max_tries = maxTries;
+}
+
+ArqFrame *ArqSender::submit(cPacket *pkt, int headerLength, int gateIndex, double now)
+{
+    _offered++;
+    if (static_cast<int>(_buffer.size()) >= _capacity) {
+        _overflows++;
+        delete pkt;
+        return nullptr;
+    }
+    ArqFrame *frame = new ArqFrame(pkt->getName(), _next_seq++);
+    frame->setByteLength(headerLength);
+    frame->encapsulate(pkt);
+    _buffer.push_back(Entry{frame, gateIndex, now, now + _timeout, 1});
+    _transmissions++;
+    return copyForTransmission(frame);
+}
+
+ArqFrame *ArqSender::copyForTransmission(const ArqFrame *frame) const
+{
+    ArqFrame *copy = frame->dup();
+    copy->setBase(_buffer.front().frame->getSeq());
+    return copy;
+}
+
+bool ArqSender::acknowledge(long seq, double now)
+{
+    for (auto it = _buffer.begin(); it != _buffer.end(); ++it) {
+        if (it->frame->getSeq() != seq)
+            continue;
+        double latency = now - it->firstSendTime;
+        _delivered++;
+        _latency_sum += latency;
+        if (latency > _max_latency)
+            _max_latency = latency;
+        delete it->frame;
+        _buffer.erase(it);
+        return true;
+    }
+    return false;
+}
+
+void ArqSender::collectExpired(double now, std::vector<Retransmission>& retransmissions)
+{
+    for (auto it = _buffer.begin(); it != _buffer.end();) {
+        if (it->deadline > now) {
+            ++it;
+        } else if (it->tries >= _max_tries) {
+            _failed++;
+            delete it->frame;
+            it = _buffer.erase(it);
+        } else {
+            it->tries++;
+            it->deadline = now + _timeout;
+            _transmissions++;
+            retransmissions.push_back(Retransmission{copyForTransmission(it->frame), it->gateIndex});
+            ++it;
+        }
+    }
+}
+
+double ArqSender::getNextDeadline() const
+{
+    double deadline = -1;
+    for (const Entry& entry : _buffer)
+        if (deadline < 0 || entry.deadline < deadline)
+            deadline = entry.deadline;
+    return deadline;
+}
+
+void ArqSender::saveState(CheckpointWriter& writer) const
+{
+    writer.putLong(_next_seq);
+    writer.putLong(_offered);
+    writer.putLong(_delivered);
+    writer.putLong(_failed);
+    writer.putLong(_overflows);
+    writer.putLong(_transmissions);
+    writer.putDouble(_latency_sum);
+    writer.putDouble(_max_latency);
+}
+
+void ArqSender::loadState(CheckpointReader& reader)
+{
+    _next_seq = reader.getLong();
+    _offered = reader.getLong();
+    _delivered = reader.getLong();
+    _failed = reader.getLong();
+    _overflows = reader.getLong();
+    _transmissions = reader.getLong();
+    _latency_sum = reader.getDouble();
+    _max_latency = reader.getDouble();
+}
+
+bool ArqReceiver::accept(const ArqFrame *frame)
+{
+    if (frame->getBase() > _next_expected) {
+        // The sender gave up on the frames in between
+        _next_expected = frame->getBase();
+        _received.erase(_received.begin(), _received.lower_bound(_next_expected));
+    }
+    long seq = frame->getSeq();
+    if (seq < _next_expected || !_received.insert(seq).second)
+        return false;
+    while (!_received.empty() && *_received.begin() == _next_expected) {
+        _received.erase(_received.begin());
+        _next_expected++;
+    }
+    return true;
+}
+
+void ArqReceiver::saveState(CheckpointWriter& writer) const
+{
+    writer.putLong(_next_expected);
+    writer.putInt(static_cast<int>(_received.size()));
+    for (long seq : _received)
+        writer.putLong(seq);
+}
+
+void ArqReceiver::loadState(CheckpointReader& reader)
+{
+    _next_expected = reader.getLong();
+    _received.clear();
+    int size = reader.getInt();
+    for (int i = 0; i < size; i++)
+        _received.insert(reader.getLong());
+}
@@ -0,0 +1,136 @@
+/*
+ * Arq.h
+ *
+ *  Created on: Jun 24, 2024
+ *      Author: pramita
+ */
+
+#ifndef ARQ_H_
+#define ARQ_H_
+
+#include <deque>
+#include <set>
+#include <vector>
+#include <omnetpp.h>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// Link-layer frame carrying one data packet (a sample or a SampleBatch)
+// with the sequence number of the ARQ sender. 'base' is the oldest sequence
+// number the sender still retransmits; the receiver forgets everything below.
+class ArqFrame : public omnetpp::cPacket {
+private:
+    long seq;
+    long base = 0;
+
+public:
+    ArqFrame(const char *name = nullptr, long seq = 0) : omnetpp::cPacket(name), seq(seq) {}
+    ArqFrame(const ArqFrame& other) : omnetpp::cPacket(other), seq(other.seq), base(other.base) {}
+    virtual ArqFrame *dup() const override { return new ArqFrame(*this); }
+    long getSeq() const { return seq; }
+    long getBase() const { return base; }
+    void setBase(long value) { base = value; }
+};
+
+// Acknowledgement of one ArqFrame
+class ArqAck : public omnetpp::cPacket {
+private:
+    long seq;
+
+public:
+    ArqAck(const char *name = nullptr, long seq = 0) : omnetpp::cPacket(name), seq(seq) {}
+    ArqAck(const ArqAck& other) : omnetpp::cPacket(other), seq(other.seq) {}
+    virtual ArqAck *dup() const override { return new ArqAck(*this); }
+    long getSeq() const { return seq; }
+};
+
+// Sending side of a selective-repeat ARQ link. Unacknowledged frames stay in
+// a bounded buffer; all of them share one timer, which the owning module
+// keeps scheduled at getNextDeadline(). ACKs do not touch the timer: when it
+// fires early, the module just reschedules it to the next real deadline.
+class ArqSender {
+private:
+    struct Entry {
+        ArqFrame *frame;
+        int gateIndex;       // Output gate of the link the frame was first sent on
+        double firstSendTime;
+        double deadline;
+        int tries;
+    };
+
+    std::deque<Entry> _buffer;
+    int _capacity = 16;
+    double _timeout = 0.025;
+    int _max_tries = 3;
+    long _next_seq = 0;
+
+    ArqFrame *copyForTransmission(const ArqFrame *frame) const;
+
+    // Statistics
+    long _offered = 0;
+    long _delivered = 0;
+    long _failed = 0;        // Given up after _max_tries transmissions
+    long _overflows = 0;     // Dropped because the buffer was full
+    long _transmissions = 0;
+    double _latency_sum = 0;
+    double _max_latency = 0;
+
+public:
+    struct Retransmission {
+        ArqFrame *frame;
+        int gateIndex;
+    };
+
+    ~ArqSender();
+    void configure(int capacity, double timeout, int maxTries);
+
+    // Wraps the packet into a frame and buffers it together with the output
+    // gate it is sent on. Returns a copy of the frame to transmit, or nullptr
+    // if the buffer is full (the packet is deleted).
+    ArqFrame *submit(omnetpp::cPacket *pkt, int headerLength, int gateIndex, double now);
+    // Removes the acknowledged frame; false for unknown or repeated ACKs
+    bool acknowledge(long seq, double now);
+    // Copies of the frames whose timeout has expired, with the gate to resend
+    // them on; frames out of tries are dropped
+    void collectExpired(double now, std::vector<Retransmission>& retransmissions);
+
+    // Earliest retransmission deadline, or -1 if nothing is outstanding
+    double getNextDeadline() const;
+    bool isEmpty() const { return _buffer.empty(); }
+
+    // Statistics only: the buffer is empty whenever a checkpoint is taken
+    void saveState(CheckpointWriter& writer) const;
+    void loadState(CheckpointReader& reader);
+
+    // Records the delivery results as scalars of the given module at finish()
+    template <class Module>
+    void recordScalars(Module *module) {
+        module->recordScalar("arqOffered", _offered);
+        module->recordScalar("arqDelivered", _delivered);
+        module->recordScalar("arqDeliveryRatio", _offered ? static_cast<double>(_delivered) / _offered : 0);
+        module->recordScalar("arqFailed", _failed);
+        module->recordScalar("arqBufferDrops", _overflows);
+        module->recordScalar("arqRetransmissions", _transmissions - (_offered - _overflows));
+        module->recordScalar("arqLatency:mean", _delivered ? _latency_sum / _delivered : 0, "s");
+        module->recordScalar("arqLatency:max", _max_latency, "s");
+    }
+};
+
+// Receiving side of an ARQ link: filters out the duplicates caused by lost
+// ACKs. Memory is bounded by the sender's buffer size, since frames below
+// the sender's base are never sent again.
+class ArqReceiver {
+private:
+    long _next_expected = 0;     // All lower sequence numbers are done with
+    std::set<long> _received;    // Received sequence numbers >= _next_expected
+
+public:
+    // True if the frame is new, false for a duplicate
+    bool accept(const ArqFrame *frame);
+
+    void saveState(CheckpointWriter& writer) const;
+    void loadState(CheckpointReader& reader);
+};
+
+#endif /* ARQ_H_ */
@@ -0,0 +1,37 @@
+/*
+ * Beacon.h
+ *
+ *  Created on: Aug 12, 2024
+ *      Author: pramita
+ */
+
+#ifndef BEACON_H_
+#define BEACON_H_
+
+#include <omnetpp.h>
+
+// Start of a hub's superframe, sent to its sensors when the hub wakes up
+// with dutyCycling. The hub is awake for activePeriod from superframeStart
+// on and sleeps until the next superframe; its sensors follow the same
+// schedule and send the samples that fell due while they slept.
+class Beacon : public omnetpp::cPacket {
+private:
+    omnetpp::simtime_t superframeStart;
+    omnetpp::simtime_t superframeInterval;
+    omnetpp::simtime_t activePeriod;
+
+public:
+    Beacon(const char *name = nullptr, omnetpp::simtime_t superframeStart = 0, omnetpp::simtime_t superframeInterval = 0,
+           omnetpp::simtime_t activePeriod = 0)
+        : omnetpp::cPacket(name), superframeStart(superframeStart), superframeInterval(superframeInterval), activePeriod(activePeriod) {}
+    Beacon(const Beacon& other)
+        : omnetpp::cPacket(other), superframeStart(other.superframeStart), superframeInterval(other.superframeInterval),
+          activePeriod(other.activePeriod) {}
+    virtual Beacon *dup() const override { return new Beacon(*this); }
+
+    omnetpp::simtime_t getSuperframeStart() const { return superframeStart; }
+    omnetpp::simtime_t getSuperframeInterval() const { return superframeInterval; }
+    omnetpp::simtime_t getActivePeriod() const { return activePeriod; }
+};
+
+#endif /* BEACON_H_ */
@@ -0,0 +1,71 @@
+/*
+ * Checkpoint.cc
+ *
+ *  Created on: May 6, 2024
+ *      Author: pramita
+ */
+
+#include "Checkpoint.h"
+
+#include <cstring>
+#include <stdexcept>
+
+void CheckpointWriter::putBytes(const void *data, size_t size) {
+    const char *p = static_cast<const char *>(data);
+    _buffer.insert(_buffer.end(), p, p + size);
+}
+
+void CheckpointWriter::putString(const std::string& value) {
+    putInt(static_cast<int32_t>(value.size()));
+    putBytes(value.data(), value.size());
+}
+
+void CheckpointWriter::putDoubles(const std::vector<double>& values) {
+    putLong(static_cast<int64_t>(values.size()));
+    putBytes(values.data(), values.size() * sizeof(double));
+}
+
+void CheckpointWriter::putInts(const std::vector<int>& values) {
+    putLong(static_cast<int64_t>(values.size()));
+    putBytes(values.data(), values.size() * sizeof(int));
+}
+
+void CheckpointReader::getBytes(void *data, size_t size) {
+    if (size > _size - _pos)
+        throw std::runtime_error("Checkpoint data truncated");
+    memcpy(data, _data + _pos, size);
+    _pos += size;
+}
+
+void CheckpointReader::skip(size_t size) {
+    if (size > _size - _pos)
+        throw std::runtime_error("Checkpoint data truncated");
+    _pos += size;
+}
+
+std::string CheckpointReader::getString() {
+    int32_t size = getInt();
+    if (size < 0 || static_cast<size_t>(size) > _size - _pos)
+        throw std::runtime_error("Checkpoint data truncated");
+    std::string value(_data + _pos, size);
+    _pos += size;
+    return value;
+}
+
+std::vector<double> CheckpointReader::getDoubles() {
+    int64_t size = getLong();
+    if (size < 0 || static_cast<uint64_t>(size) > (_size - _pos) / sizeof(double))
+        throw std::runtime_error("Checkpoint data truncated");
+    std::vector<double> values(size);
+    getBytes(values.data(), size * sizeof(double));
+    return values;
+}
+
+std::vector<int> CheckpointReader::getInts() {
+    int64_t size = getLong();
+    if (size < 0 || static_cast<uint64_t>(size) > (_size - _pos) / sizeof(int))
+        throw std::runtime_error("Checkpoint data truncated");
+    std::vector<int> values(size);
+    getBytes(values.data(), size * sizeof(int));
+    return values;
+}
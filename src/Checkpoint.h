@@ -0,0 +1,74 @@
+/*
+ * Checkpoint.h
+ *
+ *  Created on: May 6, 2024
+ *      Author: pramita
+ */
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary encoding of module state for checkpoint files. Values are written
+// in host byte order without padding; a file is only meant to be read back
+// by the same build on the same platform.
+class CheckpointWriter {
+private:
+    std::vector<char> _buffer;
+
+public:
+    void putBytes(const void *data, size_t size);
+    void putInt(int32_t value) { putBytes(&value, sizeof(value)); }
+    void putLong(int64_t value) { putBytes(&value, sizeof(value)); }
+    void putBool(bool value) { char c = value; putBytes(&c, 1); }
+    void putFloat(float value) { putBytes(&value, sizeof(value)); }
+    void putDouble(double value) { putBytes(&value, sizeof(value)); }
+    void putString(const std::string& value);
+    void putDoubles(const std::vector<double>& values);
+    void putInts(const std::vector<int>& values);
+
+    const std::vector<char>& getBuffer() const { return _buffer; }
+    void clear() { _buffer.clear(); }
+};
+
+class CheckpointReader {
+private:
+    const char *_data;
+    size_t _size;
+    size_t _pos = 0;
+
+public:
+    CheckpointReader(const char *data, size_t size) : _data(data), _size(size) {}
+
+    // Throws std::runtime_error when reading past the end of the data
+    void getBytes(void *data, size_t size);
+    int32_t getInt() { int32_t v; getBytes(&v, sizeof(v)); return v; }
+    int64_t getLong() { int64_t v; getBytes(&v, sizeof(v)); return v; }
+    bool getBool() { char c; getBytes(&c, 1); return c != 0; }
+    float getFloat() { float v; getBytes(&v, sizeof(v)); return v; }
+    double getDouble() { double v; getBytes(&v, sizeof(v)); return v; }
+    std::string getString();
+    std::vector<double> getDoubles();
+    std::vector<int> getInts();
+
+    void skip(size_t size);
+    size_t getPosition() const { return _pos; }
+    bool atEnd() const { return _pos >= _size; }
+};
+
+// Implemented by components whose state can be written to and restored from
+// a checkpoint. loadState() must read exactly what saveState() wrote.
+class Checkpointable {
+public:
+    virtual ~Checkpointable() {}
+    virtual void saveState(CheckpointWriter& writer) = 0;
+    virtual void loadState(CheckpointReader& reader) = 0;
+    // Packets held outside the event queue (e.g. in transmit queues) cannot
+    // be captured; a checkpoint is deferred while any component has some
+    virtual bool hasPendingPackets() const { return false; }
+};
+
+#endif /* CHECKPOINT_H_ */
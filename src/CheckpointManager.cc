@@ -0,0 +1,258 @@
+/*
+ * CheckpointManager.cc
+ *
+ *  Created on: May 6, 2024
+ *      Author: pramita
+ */
+
+#include "CheckpointManager.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+using namespace omnetpp;
+
+Define_Module(CheckpointManager);
+
+static const char CHECKPOINT_MAGIC[8] = {'W', 'B', 'A', 'N', 'C', 'K', 'P', 'T'};
+static const int CHECKPOINT_VERSION = 1;
+
+CheckpointManager::~CheckpointManager()
+{
+    cancelAndDelete(checkpointMsg);
+}
+
+CheckpointManager *CheckpointManager::find()
+{
+    cModule *network = getSimulation()->getSystemModule();
+    return network ? dynamic_cast<CheckpointManager *>(network->getSubmodule("checkpoint")) : nullptr;
+}
+
+bool CheckpointManager::restore(cModule *module)
+{
+    CheckpointManager *manager = find();
+    return manager != nullptr && manager->restoreModule(module);
+}
+
+bool CheckpointManager::isCheckpointing()
+{
+    CheckpointManager *manager = find();
+    return manager != nullptr && manager->par("checkpointInterval").doubleValue() > 0;
+}
+
+double CheckpointManager::remainingTime(cMessage *timer)
+{
+    if (timer == nullptr || !timer->isScheduled())
+        return -1;
+    return SIMTIME_DBL(timer->getArrivalTime() - simTime());
+}
+
+void CheckpointManager::initialize(int stage)
+{
+    if (stage == 0) {
+        checkpointInterval = par("checkpointInterval");
+        checkpointRetryDelay = par("checkpointRetryDelay");
+        checkpointFile = par("checkpointFile").stdstringValue();
+        restoreFile = par("restoreFile").stdstringValue();
+
+        if (checkpointInterval > 0) {
+            checkpointMsg = new cMessage("checkpoint");
+            // Last event of its time instant, after any batched hub processing
+            checkpointMsg->setSchedulingPriority(SHRT_MAX);
+            scheduleAt(simTime() + checkpointInterval, checkpointMsg);
+        }
+    } else if (stage == 1) {
+        // All modules have initialized (and restored themselves) by now
+        if (!restoreFile.empty()) {
+            loadRestoreFile();
+            restoreRngs();
+            EV << "Restored " << numModulesRestored << " modules from " << restoreFile
+               << " taken at t=" << restoredTime << "s\n";
+        }
+    }
+}
+
+void CheckpointManager::handleMessage(cMessage *msg)
+{
+    if (msg != checkpointMsg)
+        throw cRuntimeError("Unexpected message %s", msg->getName());
+
+    if (!isQuiescent()) {
+        // Packets in flight cannot be captured; try again shortly
+        numCheckpointsDeferred++;
+        scheduleAt(simTime() + checkpointRetryDelay, checkpointMsg);
+        return;
+    }
+    writeCheckpoint();
+    scheduleAt(simTime() + checkpointInterval, checkpointMsg);
+}
+
+bool CheckpointManager::isQuiescent() const
+{
+    cFutureEventSet *fes = getSimulation()->getFES();
+    for (int i = 0; i < fes->getLength(); i++) {
+        cMessage *msg = dynamic_cast<cMessage *>(fes->get(i));
+        if (msg != nullptr && !msg->isSelfMessage())
+            return false;
+    }
+    return !hasPendingPackets(getSimulation()->getSystemModule());
+}
+
+bool CheckpointManager::hasPendingPackets(cModule *module) const
+{
+    for (cModule::SubmoduleIterator it(module); !it.end(); ++it) {
+        Checkpointable *checkpointable = dynamic_cast<Checkpointable *>(*it);
+        if ((checkpointable != nullptr && checkpointable->hasPendingPackets()) || hasPendingPackets(*it))
+            return true;
+    }
+    return false;
+}
+
+void CheckpointManager::collectModules(cModule *module, CheckpointWriter& writer, int& count,
+                                       std::vector<cRNG *>& rngs, CheckpointWriter& rngWriter, int& rngCount)
+{
+    for (cModule::SubmoduleIterator it(module); !it.end(); ++it) {
+        cModule *submodule = *it;
+        if (Checkpointable *checkpointable = dynamic_cast<Checkpointable *>(submodule)) {
+            CheckpointWriter state;
+            checkpointable->saveState(state);
+            writer.putString(submodule->getFullPath());
+            writer.putLong(state.getBuffer().size());
+            writer.putBytes(state.getBuffer().data(), state.getBuffer().size());
+            count++;
+
+            // Modules usually share physical RNGs; record each one once
+            cRNG *rng = submodule->getRNG(0);
+            if (std::find(rngs.begin(), rngs.end(), rng) == rngs.end()) {
+                rngs.push_back(rng);
+                rngWriter.putString(submodule->getFullPath());
+                rngWriter.putLong(rng->getNumbersDrawn());
+                rngCount++;
+            }
+        }
+        collectModules(submodule, writer, count, rngs, rngWriter, rngCount);
+    }
+}
+
+void CheckpointManager::writeCheckpoint()
+{
+    CheckpointWriter modules, rngWriter;
+    std::vector<cRNG *> rngs;
+    int count = 0, rngCount = 0;
+    collectModules(getSimulation()->getSystemModule(), modules, count, rngs, rngWriter, rngCount);
+
+    CheckpointWriter header;
+    header.putBytes(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header.putInt(CHECKPOINT_VERSION);
+    header.putDouble(SIMTIME_DBL(simTime()) + restoredTime);
+    header.putInt(rngCount);
+    header.putInt(count);
+
+    // Write to a temporary file first so that a crash never leaves a truncated checkpoint behind
+    std::string tmpFile = checkpointFile + ".tmp";
+    std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw cRuntimeError("Cannot open checkpoint file '%s'", tmpFile.c_str());
+    out.write(header.getBuffer().data(), header.getBuffer().size());
+    out.write(rngWriter.getBuffer().data(), rngWriter.getBuffer().size());
+    out.write(modules.getBuffer().data(), modules.getBuffer().size());
+    out.close();
+    if (!out || rename(tmpFile.c_str(), checkpointFile.c_str()) != 0)
+        throw cRuntimeError("Cannot write checkpoint file '%s'", checkpointFile.c_str());
+
+    numCheckpointsWritten++;
+    EV << "Checkpoint of " << count << " modules written to " << checkpointFile << " at t=" << simTime() << "s\n";
+}
+
+void CheckpointManager::loadRestoreFile()
+{
+    if (restoreLoaded)
+        return;
+    restoreLoaded = true;
+
+    std::ifstream in(restoreFile, std::ios::binary);
+    if (!in)
+        throw cRuntimeError("Cannot open checkpoint file '%s'", restoreFile.c_str());
+    restoreData.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    try {
+        CheckpointReader reader(restoreData.data(), restoreData.size());
+        char magic[sizeof(CHECKPOINT_MAGIC)];
+        reader.getBytes(magic, sizeof(magic));
+        if (memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 || reader.getInt() != CHECKPOINT_VERSION)
+            throw cRuntimeError("'%s' is not a checkpoint file of this version", restoreFile.c_str());
+        restoredTime = reader.getDouble();
+        int rngCount = reader.getInt();
+        int count = reader.getInt();
+        for (int i = 0; i < rngCount; i++) {
+            std::string path = reader.getString();
+            rngDraws.push_back(std::make_pair(path, static_cast<unsigned long>(reader.getLong())));
+        }
+        for (int i = 0; i < count; i++) {
+            std::string path = reader.getString();
+            size_t size = reader.getLong();
+            moduleBlobs[path] = std::make_pair(reader.getPosition(), size);
+            reader.skip(size);
+        }
+    }
+    catch (std::runtime_error& e) {
+        throw cRuntimeError("Cannot read checkpoint file '%s': %s", restoreFile.c_str(), e.what());
+    }
+}
+
+bool CheckpointManager::restoreModule(cModule *module)
+{
+    // Modules may initialize before this one does
+    if (!restoreLoaded)
+        restoreFile = par("restoreFile").stdstringValue();
+    if (restoreFile.empty())
+        return false;
+    Checkpointable *checkpointable = dynamic_cast<Checkpointable *>(module);
+    if (checkpointable == nullptr)
+        return false;
+
+    loadRestoreFile();
+    auto it = moduleBlobs.find(module->getFullPath());
+    if (it == moduleBlobs.end())
+        throw cRuntimeError("Checkpoint file '%s' contains no state for %s", restoreFile.c_str(), module->getFullPath().c_str());
+
+    try {
+        CheckpointReader reader(restoreData.data() + it->second.first, it->second.second);
+        checkpointable->loadState(reader);
+        if (!reader.atEnd())
+            throw std::runtime_error("unread state left over");
+    }
+    catch (std::runtime_error& e) {
+        throw cRuntimeError("Cannot restore %s from '%s': %s", module->getFullPath().c_str(), restoreFile.c_str(), e.what());
+    }
+    numModulesRestored++;
+    return true;
+}
+
+void CheckpointManager::restoreRngs()
+{
+    // Restored modules skip their start-up draws, so fast-forwarding every
+    // RNG to its recorded draw count reproduces the original streams
+    for (auto& entry : rngDraws) {
+        cModule *module = getSimulation()->getModuleByPath(entry.first.c_str());
+        cRNG *rng = module->getRNG(0);
+        unsigned long drawn = rng->getNumbersDrawn();
+        if (drawn > entry.second)
+            throw cRuntimeError("RNG of %s has already drawn %lu numbers, more than the %lu in the checkpoint",
+                                entry.first.c_str(), drawn, entry.second);
+        for (unsigned long i = drawn; i < entry.second; i++)
+            rng->intRand();
+    }
+}
+
+void CheckpointManager::finish()
+{
+    recordScalar("checkpointsWritten", numCheckpointsWritten);
+    recordScalar("checkpointsDeferred", numCheckpointsDeferred);
+    if (!restoreFile.empty())
+        recordScalar("restoredFromTime", restoredTime, "s");
+}
@@ -0,0 +1,77 @@
+/*
+ * CheckpointManager.h
+ *
+ *  Created on: May 6, 2024
+ *      Author: pramita
+ */
+
+#ifndef CHECKPOINTMANAGER_H_
+#define CHECKPOINTMANAGER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <omnetpp.h>
+#include "Checkpoint.h"
+
+// Periodically writes the state of all Checkpointable modules, the draw
+// counts of their RNGs and their pending timers to a binary file, and
+// restores a run from such a file.
+//
+// Snapshots are only taken at instants when no packet is in flight on a
+// link, so the future event set consists of module timers only; if packets
+// are in flight the snapshot is retried after checkpointRetryDelay. A
+// restored run starts at simulation time 0 with all timers shifted by the
+// checkpoint time.
+class CheckpointManager : public omnetpp::cSimpleModule {
+protected:
+    omnetpp::simtime_t checkpointInterval;
+    omnetpp::simtime_t checkpointRetryDelay;
+    std::string checkpointFile;
+    std::string restoreFile;
+    omnetpp::cMessage *checkpointMsg = nullptr;
+    int numCheckpointsWritten = 0;
+    int numCheckpointsDeferred = 0;
+
+    // Contents of the restore file, loaded on first use
+    bool restoreLoaded = false;
+    double restoredTime = 0;
+    std::vector<char> restoreData;
+    std::map<std::string, std::pair<size_t, size_t>> moduleBlobs; // path -> (offset, size)
+    std::vector<std::pair<std::string, unsigned long>> rngDraws;  // module path -> numbers drawn from its rng 0
+    int numModulesRestored = 0;
+
+    virtual int numInitStages() const override { return 2; }
+    virtual void initialize(int stage) override;
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+    virtual void finish() override;
+
+    virtual bool isQuiescent() const;
+    virtual bool hasPendingPackets(omnetpp::cModule *module) const;
+    virtual void writeCheckpoint();
+    virtual void collectModules(omnetpp::cModule *module, CheckpointWriter& writer, int& count,
+                                std::vector<omnetpp::cRNG *>& rngs, CheckpointWriter& rngWriter, int& rngCount);
+    virtual void loadRestoreFile();
+    virtual bool restoreModule(omnetpp::cModule *module);
+    virtual void restoreRngs();
+
+public:
+    virtual ~CheckpointManager();
+
+    // Returns the manager of the current network, or nullptr if there is none
+    static CheckpointManager *find();
+
+    // Called by Checkpointable modules at the end of their own set-up in
+    // initialize(). Returns true if the module state was restored from a
+    // checkpoint, in which case the module must skip its start-up actions.
+    static bool restore(omnetpp::cModule *module);
+
+    // True if the network periodically writes checkpoints; reads the
+    // parameter, so it may be called before the manager has initialized
+    static bool isCheckpointing();
+
+    // Time until the timer fires, or -1 if it is not scheduled
+    static double remainingTime(omnetpp::cMessage *timer);
+};
+
+#endif /* CHECKPOINTMANAGER_H_ */
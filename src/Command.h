@@ -0,0 +1,52 @@
+/*
+ * Command.h
+ *
+ *  Created on: Jun 17, 2024
+ *      Author: pramita
+ */
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+#include <omnetpp.h>
+
+// Downlink command from the OBN, addressed to a hub or sensor by nodeId and
+// relayed hop by hop along the nodes' routing tables.
+class Command : public omnetpp::cPacket {
+public:
+    enum Type {
+        SET_SAMPLE_INTERVAL,  // Sensor: sample every 'value' seconds
+        SET_PROCESS_NOISE,    // Hub: process noise of its Kalman filters becomes 'value'
+        SLEEP                 // Sensor: stop sampling and sleep for 'value' seconds
+    };
+
+private:
+    Type type;
+    int destination;
+    double value;
+
+public:
+    Command(const char *name = nullptr, Type type = SET_SAMPLE_INTERVAL, int destination = -1, double value = 0)
+        : omnetpp::cPacket(name), type(type), destination(destination), value(value) {}
+    Command(const Command& other)
+        : omnetpp::cPacket(other), type(other.type), destination(other.destination), value(other.value) {}
+    virtual Command *dup() const override { return new Command(*this); }
+
+    Type getType() const { return type; }
+    int getDestination() const { return destination; }
+    double getValue() const { return value; }
+
+    static const char *getTypeName(Type type);
+};
+
+inline const char *Command::getTypeName(Type type)
+{
+    switch (type) {
+        case SET_SAMPLE_INTERVAL: return "setSampleInterval";
+        case SET_PROCESS_NOISE: return "setProcessNoise";
+        case SLEEP: return "sleep";
+    }
+    return "?";
+}
+
+#endif /* COMMAND_H_ */
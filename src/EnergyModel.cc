@@ -0,0 +1,122 @@
+/*
+ * EnergyModel.cc
+ *
+ *  Created on: Apr 22, 2024
+ *      Author: pramita
+ */
+
+#include "EnergyModel.h"
+
+#include <limits>
+
+#include "Checkpoint.h"
+
+EnergyModel::EnergyModel() {
+    for (int i = 0; i < NUM_STATES; i++) {
+        _current[i] = 0;
+        _state_energy[i] = 0;
+        _state_time[i] = 0;
+    }
+}
+
+void EnergyModel::configure(double voltage, double capacity_mAh, double tx_mA, double rx_mA,
+                            double idle_mA, double sleep_mA, double bitrate) {
+    _voltage = voltage;
+    _capacity = capacity_mAh * 3.6 * voltage; // mAh -> As -> J
+    _current[TX] = tx_mA / 1000.0;
+    _current[RX] = rx_mA / 1000.0;
+    _current[IDLE] = idle_mA / 1000.0;
+    _current[SLEEP] = sleep_mA / 1000.0;
+    _bitrate = bitrate;
+}
+
+void EnergyModel::accrue(State state, double duration, double start) {
+    if (duration <= 0)
+        return;
+    double power = _current[state] * _voltage;
+    double energy = power * duration;
+    if (_capacity > 0 && _depletion_time < 0 && _consumed + energy >= _capacity)
+        _depletion_time = power > 0 ? start + (_capacity - _consumed) / power : start;
+    _consumed += energy;
+    _state_energy[state] += energy;
+    _state_time[state] += duration;
+}
+
+void EnergyModel::update(double now) {
+    now += _time_base;
+    if (now > _last_update) {
+        accrue(_state, now - _last_update, _last_update);
+        _last_update = now;
+    }
+}
+
+void EnergyModel::setState(State state, double now) {
+    update(now);
+    _state = state;
+}
+
+void EnergyModel::burst(State state, long bits, double now) {
+    update(now);
+    // The radio is busy for the airtime of the packet; bursts issued at the
+    // same instant are accounted back to back
+    double airtime = bits / _bitrate;
+    accrue(state, airtime, _last_update);
+    _last_update += airtime;
+}
+
+void EnergyModel::chargeTx(long bits, double now) {
+    burst(TX, bits, now);
+}
+
+void EnergyModel::chargeRx(long bits, double now) {
+    burst(RX, bits, now);
+}
+
+double EnergyModel::getResidualEnergy() const {
+    if (_capacity <= 0)
+        return std::numeric_limits<double>::infinity();
+    return _capacity > _consumed ? _capacity - _consumed : 0;
+}
+
+double EnergyModel::estimateLifetime(double now) const {
+    now += _time_base;
+    if (_depletion_time >= 0)
+        return _depletion_time;
+    if (_capacity <= 0 || _consumed <= 0 || now <= 0)
+        return std::numeric_limits<double>::infinity();
+    return _capacity / (_consumed / now);
+}
+
+const char *EnergyModel::getStateName(State state) {
+    switch (state) {
+        case TX: return "tx";
+        case RX: return "rx";
+        case IDLE: return "idle";
+        case SLEEP: return "sleep";
+        default: return "?";
+    }
+}
+
+void EnergyModel::saveState(CheckpointWriter& writer, double now) const {
+    writer.putDouble(now + _time_base);
+    writer.putDouble(_last_update);
+    writer.putInt(_state);
+    writer.putDouble(_consumed);
+    for (int i = 0; i < NUM_STATES; i++) {
+        writer.putDouble(_state_energy[i]);
+        writer.putDouble(_state_time[i]);
+    }
+    writer.putDouble(_depletion_time);
+}
+
+void EnergyModel::loadState(CheckpointReader& reader, double now) {
+    _time_base = reader.getDouble() - now;
+    _last_update = reader.getDouble();
+    _state = static_cast<State>(reader.getInt());
+    _consumed = reader.getDouble();
+    for (int i = 0; i < NUM_STATES; i++) {
+        _state_energy[i] = reader.getDouble();
+        _state_time[i] = reader.getDouble();
+    }
+    _depletion_time = reader.getDouble();
+}
@@ -0,0 +1,87 @@
+/*
+ * EnergyModel.h
+ *
+ *  Created on: Apr 22, 2024
+ *      Author: pramita
+ */
+
+#ifndef ENERGYMODEL_H_
+#define ENERGYMODEL_H_
+
+#include <string>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// Radio energy accounting for one node. The node is always in one background
+// state (idle or sleep) whose current is integrated lazily between state
+// changes; transmissions and receptions are charged as bursts whose airtime
+// follows from the packet size. Every call is O(1) and no timer is needed,
+// so battery depletion is detected at the next accounting call and its exact
+// time is interpolated.
+class EnergyModel {
+public:
+    enum State { TX, RX, IDLE, SLEEP, NUM_STATES };
+
+private:
+    double _voltage = 3.0;         // V
+    double _capacity = 0;          // J, 0 means unlimited
+    double _current[NUM_STATES];   // A
+    double _bitrate = 250000;      // bps
+
+    State _state = IDLE;
+    double _last_update = 0;       // s, time up to which energy has been accounted
+    double _consumed = 0;          // J
+    double _state_energy[NUM_STATES];
+    double _state_time[NUM_STATES];
+    double _depletion_time = -1;   // s, negative while the battery is not depleted
+    double _time_base = 0;         // s, added to simulation time after a restore from a checkpoint
+
+    void accrue(State state, double duration, double start);
+    void burst(State state, long bits, double now);
+
+public:
+    EnergyModel();
+    // Currents in mA, capacity in mAh (0 = unlimited), bitrate in bps
+    void configure(double voltage, double capacity_mAh, double tx_mA, double rx_mA,
+                   double idle_mA, double sleep_mA, double bitrate);
+
+    void setState(State state, double now);
+    void chargeTx(long bits, double now);
+    void chargeRx(long bits, double now);
+    void update(double now);
+
+    State getState() const { return _state; }
+    double getConsumedEnergy() const { return _consumed; }
+    double getStateEnergy(State state) const { return _state_energy[state]; }
+    double getStateTime(State state) const { return _state_time[state]; }
+    double getResidualEnergy() const;
+    bool isDepleted() const { return _depletion_time >= 0; }
+    double getDepletionTime() const { return _depletion_time; }
+    double getAirtime(long bits) const { return bits / _bitrate; }
+    // Depletion time extrapolated from the average power drawn so far
+    double estimateLifetime(double now) const;
+
+    static const char *getStateName(State state);
+
+    // Times are kept on the axis of the original run, so a restored model
+    // continues the accounting as if the run had not been interrupted
+    void saveState(CheckpointWriter& writer, double now) const;
+    void loadState(CheckpointReader& reader, double now);
+
+    // Records the energy results as scalars of the given module at finish()
+    template <class Module>
+    void recordScalars(Module *module, double now) {
+        update(now);
+        module->recordScalar("energyConsumed", _consumed, "J");
+        for (int s = 0; s < NUM_STATES; s++) {
+            std::string name = std::string("energy:") + getStateName(static_cast<State>(s));
+            module->recordScalar(name.c_str(), _state_energy[s], "J");
+        }
+        module->recordScalar("estimatedLifetime", estimateLifetime(now), "s");
+        if (isDepleted())
+            module->recordScalar("batteryDepletionTime", _depletion_time, "s");
+    }
+};
+
+#endif /* ENERGYMODEL_H_ */
@@ -0,0 +1,19 @@
+/*
+ * ForwardingRule.h
+ *
+ *  Created on: May 27, 2024
+ *      Author: pramita
+ */
+
+#ifndef FORWARDINGRULE_H_
+#define FORWARDINGRULE_H_
+
+#include <cmath>
+
+// Decision shared by the hubs and the OBN: a sample is passed on when the
+// Kalman prediction matches it exactly or is off by exactly 10.
+inline bool isForwarded(double predictionError) {
+    return predictionError == 0 || std::abs(predictionError) == 10;
+}
+
+#endif /* FORWARDINGRULE_H_ */
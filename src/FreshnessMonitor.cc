@@ -0,0 +1,117 @@
+/*
+ * FreshnessMonitor.cc
+ *
+ *  Created on: Jul 1, 2024
+ *      Author: pramita
+ */
+
+#include "FreshnessMonitor.h"
+#include "Checkpoint.h"
+
+#include <algorithm>
+
+void FreshnessMonitor::integrateAge(Source& source, double now) const
+{
+    // The age grows linearly from (lastUpdate - g) to (now - g): trapezoid
+    double g = source.freshestGenerationTime;
+    source.ageIntegral += (now - source.lastUpdate) * ((source.lastUpdate - g) + (now - g)) / 2;
+    source.lastUpdate = now;
+}
+
+void FreshnessMonitor::collect(int sourceId, long seq, double generationTime, long suppressed, double now, double& latency, double& age)
+{
+    Source& source = _sources[sourceId];
+    latency = now - generationTime;
+    source.latency.collect(latency);
+
+    if (source.received++ == 0) {
+        source.firstReception = source.lastUpdate = now;
+        source.freshestGenerationTime = generationTime;
+    } else {
+        integrateAge(source, now);
+        if (generationTime > source.freshestGenerationTime) {
+            source.peakAge.collect(now - source.freshestGenerationTime);
+            source.freshestGenerationTime = generationTime;
+        }
+    }
+    age = now - source.freshestGenerationTime;
+
+    if (seq <= source.lastSeq) {
+        source.outOfOrder++;
+        return;
+    }
+    long missing = seq - source.lastSeq - 1;
+    long notForwarded = 0;
+    if (suppressed >= 0) {
+        notForwarded = std::min(missing, std::max(0L, suppressed - source.lastSuppressed));
+        source.lastSuppressed = std::max(source.lastSuppressed, suppressed);
+    }
+    source.suppressed += notForwarded;
+    if (missing > notForwarded) {
+        source.gaps++;
+        source.lost += missing - notForwarded;
+    }
+    source.lastSeq = seq;
+}
+
+double FreshnessMonitor::getMeanAge(int sourceId, double now) const
+{
+    auto it = _sources.find(sourceId);
+    if (it == _sources.end() || it->second.received == 0 || now <= it->second.firstReception)
+        return 0;
+    Source source = it->second;
+    integrateAge(source, now);
+    return source.ageIntegral / (now - source.firstReception);
+}
+
+size_t FreshnessMonitor::getHeapBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& entry : _sources)
+        bytes += sizeof(entry) + 4 * sizeof(void *) + entry.second.latency.getHeapBytes() + entry.second.peakAge.getHeapBytes();
+    return bytes;
+}
+
+void FreshnessMonitor::saveState(CheckpointWriter& writer, double now) const
+{
+    writer.putInt(static_cast<int>(_sources.size()));
+    for (const auto& entry : _sources) {
+        const Source& source = entry.second;
+        writer.putInt(entry.first);
+        writer.putLong(source.lastSeq);
+        writer.putDouble(source.freshestGenerationTime - now);
+        writer.putDouble(source.firstReception - now);
+        writer.putDouble(source.lastUpdate - now);
+        writer.putDouble(source.ageIntegral);
+        writer.putLong(source.received);
+        writer.putLong(source.gaps);
+        writer.putLong(source.suppressed);
+        writer.putLong(source.lost);
+        writer.putLong(source.lastSuppressed);
+        writer.putLong(source.outOfOrder);
+        source.latency.saveState(writer);
+        source.peakAge.saveState(writer);
+    }
+}
+
+void FreshnessMonitor::loadState(CheckpointReader& reader, double now)
+{
+    _sources.clear();
+    int numSources = reader.getInt();
+    for (int i = 0; i < numSources; i++) {
+        Source& source = _sources[reader.getInt()];
+        source.lastSeq = reader.getLong();
+        source.freshestGenerationTime = reader.getDouble() + now;
+        source.firstReception = reader.getDouble() + now;
+        source.lastUpdate = reader.getDouble() + now;
+        source.ageIntegral = reader.getDouble();
+        source.received = reader.getLong();
+        source.gaps = reader.getLong();
+        source.suppressed = reader.getLong();
+        source.lost = reader.getLong();
+        source.lastSuppressed = reader.getLong();
+        source.outOfOrder = reader.getLong();
+        source.latency.loadState(reader);
+        source.peakAge.loadState(reader);
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * FreshnessMonitor.h
+ *
+ *  Created on: Jul 1, 2024
+ *      Author: pramita
+ */
+
+#ifndef FRESHNESSMONITOR_H_
+#define FRESHNESSMONITOR_H_
+
+#include <map>
+#include <string>
+#include "StreamingHistogram.h"
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// How fresh the OBN's view of each sensor is. For every received sample it
+// records the end-to-end latency; per sensor it integrates the age of
+// information (time since the generation of the freshest sample received)
+// exactly over the sawtooth, and counts sequence gaps. The sequence numbers
+// missing in a gap are split into samples the hub suppressed by design and
+// samples lost on the way, using the hub's count of suppressed samples
+// carried by each forwarded one. Memory is constant per sensor, so it can
+// stay enabled in every run.
+class FreshnessMonitor {
+public:
+    struct Source {
+        long lastSeq = -1;
+        double freshestGenerationTime = 0;
+        double firstReception = 0;
+        double lastUpdate = 0;       // Age is integrated up to here
+        double ageIntegral = 0;
+        long received = 0;
+        long gaps = 0;               // Sequence discontinuities with at least one lost sample
+        long suppressed = 0;         // Sequence numbers the hub did not forward
+        long lost = 0;               // Sequence numbers never received although forwarded or never reaching the hub
+        long lastSuppressed = 0;     // Hub's count of suppressed samples at the last in-order sample
+        long outOfOrder = 0;         // Older than a sample received before
+        StreamingHistogram latency;
+        StreamingHistogram peakAge;  // Age just before each update
+    };
+
+private:
+    std::map<int, Source> _sources; // Keyed by the sensor's module id
+
+    void integrateAge(Source& source, double now) const;
+
+public:
+    // Records a received sample; suppressed is the hub's count of the
+    // sensor's samples it has not forwarded so far (-1 if unknown, in which
+    // case missing samples count as lost). Returns the sample's latency and
+    // the sensor's age of information afterwards.
+    void collect(int sourceId, long seq, double generationTime, long suppressed, double now, double& latency, double& age);
+
+    const std::map<int, Source>& getSources() const { return _sources; }
+    // Heap memory of the per-sensor state, estimated like a std::map's nodes
+    size_t getHeapBytes() const;
+    // Time-average age of information since the first sample of the source
+    double getMeanAge(int sourceId, double now) const;
+
+    // Times are stored relative to now, as a restored run starts again at t=0
+    void saveState(CheckpointWriter& writer, double now) const;
+    void loadState(CheckpointReader& reader, double now);
+
+    // Records the per-sensor results as scalars of the given module at
+    // finish(); nameOf maps a sensor's module id to its name
+    template <class Module, class NameOf>
+    void recordScalars(Module *module, double now, NameOf nameOf) {
+        for (const auto& entry : _sources) {
+            const Source& source = entry.second;
+            std::string prefix = nameOf(entry.first) + ":";
+            module->recordScalar((prefix + "samplesReceived").c_str(), source.received);
+            module->recordScalar((prefix + "sequenceGaps").c_str(), source.gaps);
+            module->recordScalar((prefix + "samplesSuppressed").c_str(), source.suppressed);
+            module->recordScalar((prefix + "samplesLost").c_str(), source.lost);
+            module->recordScalar((prefix + "samplesOutOfOrder").c_str(), source.outOfOrder);
+            module->recordScalar((prefix + "e2eLatency:mean").c_str(), source.latency.getMean(), "s");
+            module->recordScalar((prefix + "e2eLatency:p50").c_str(), source.latency.getQuantile(0.5), "s");
+            module->recordScalar((prefix + "e2eLatency:p95").c_str(), source.latency.getQuantile(0.95), "s");
+            module->recordScalar((prefix + "e2eLatency:p99").c_str(), source.latency.getQuantile(0.99), "s");
+            module->recordScalar((prefix + "e2eLatency:max").c_str(), source.latency.getMax(), "s");
+            module->recordScalar((prefix + "ageOfInformation:mean").c_str(), getMeanAge(entry.first, now), "s");
+            module->recordScalar((prefix + "peakAgeOfInformation:mean").c_str(), source.peakAge.getMean(), "s");
+            module->recordScalar((prefix + "peakAgeOfInformation:p95").c_str(), source.peakAge.getQuantile(0.95), "s");
+        }
+    }
+};
+
+#endif /* FRESHNESSMONITOR_H_ */
@@ -0,0 +1,117 @@
+/*
+ * HubFilters.h
+ *
+ *  Created on: May 27, 2024
+ *      Author: pramita
+ */
+
+#ifndef HUBFILTERS_H_
+#define HUBFILTERS_H_
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "SimpleKalmanFilter.h"
+#include "ForwardingRule.h"
+
+struct FilterSettings {
+    float mea_e;
+    float est_e;
+    float q;
+};
+
+inline SimpleKalmanFilter makeFilter(const FilterSettings& settings) {
+    return SimpleKalmanFilter(settings.mea_e, settings.est_e, settings.q);
+}
+
+struct ChildFilterConfig {
+    const char *sensorName;   // Submodule name, e.g. "Node_11"
+    FilterSettings filter;
+    bool truncated;           // The filter sees the value truncated to an int
+};
+
+// Kalman filter settings of one hub: the filters it runs on its children's
+// samples and the filter the OBN runs on the samples it forwards. Shared by
+// Hub_node1/2/3, OBN_node and the fast path (fastpath/FilterPipeline), so
+// that the two cannot drift apart.
+struct HubFilterConfig {
+    const char *hubName;      // Submodule name, e.g. "Hub_1"
+    ChildFilterConfig children[2];
+    FilterSettings obnFilter;
+};
+
+static const int NUM_HUBS = 3;
+
+inline const HubFilterConfig& getHubFilterConfig(int hub) {
+    static const HubFilterConfig configs[NUM_HUBS] = {
+        {"Hub_1", {{"Node_11", {2.0, 2.0, 0.01}, false}, {"Node_12", {2.0, 2.0, 0.01}, false}}, {2.0, 2.0, 0.01}},
+        {"Hub_2", {{"Node_21", {2.0, 2.0, 0.01}, false}, {"Node_22", {2.0, 2.0, 0.01}, false}}, {2.0, 2.0, 0.01}},
+        {"Hub_3", {{"Node_31", {0.01, 0.01, 0.01}, true}, {"Node_32", {0.5, 0.5, 0.01}, true}}, {0.5, 0.5, 0.01}},
+    };
+    return configs[hub];
+}
+
+// What a hub makes of one sample once its filter has predicted it
+struct FilterOutcome {
+    double filteredValue;
+    double predictionError;
+    bool forwarded;           // Passed on to the OBN, otherwise suppressed
+};
+
+inline FilterOutcome evaluatePrediction(double filteredValue, double receivedValue) {
+    double predictionError = std::abs(filteredValue - receivedValue);
+    return FilterOutcome{filteredValue, predictionError, isForwarded(predictionError)};
+}
+
+// The child filters of one hub, built from its HubFilterConfig
+class HubFilters {
+private:
+    const HubFilterConfig& _config;
+    std::vector<SimpleKalmanFilter> _filters; // In the order of _config.children
+
+public:
+    explicit HubFilters(int hub) : _config(getHubFilterConfig(hub)) {
+        for (const ChildFilterConfig& child : _config.children)
+            _filters.push_back(makeFilter(child.filter));
+    }
+
+    const HubFilterConfig& getConfig() const { return _config; }
+    int getNumChildren() const { return static_cast<int>(_filters.size()); }
+
+    // Index of the child with the given submodule name, -1 if it is not one of this hub's children
+    int findChild(const char *sensorName) const {
+        for (int i = 0; i < getNumChildren(); i++)
+            if (strcmp(sensorName, _config.children[i].sensorName) == 0)
+                return i;
+        return -1;
+    }
+
+    // Runs the child's filter on the value and returns the prediction
+    double filter(int child, double value) {
+        if (_config.children[child].truncated)
+            value = static_cast<int>(value);
+        return _filters[child].updateEstimate(value);
+    }
+
+    FilterOutcome apply(int child, double value) { return evaluatePrediction(filter(child, value), value); }
+
+    void setProcessNoise(float q) {
+        for (SimpleKalmanFilter& filter : _filters)
+            filter.setProcessNoise(q);
+    }
+
+    size_t getHeapBytes() const { return _filters.capacity() * sizeof(SimpleKalmanFilter); }
+
+    void saveState(CheckpointWriter& writer) const {
+        for (const SimpleKalmanFilter& filter : _filters)
+            filter.saveState(writer);
+    }
+
+    void loadState(CheckpointReader& reader) {
+        for (SimpleKalmanFilter& filter : _filters)
+            filter.loadState(reader);
+    }
+};
+
+#endif /* HUBFILTERS_H_ */
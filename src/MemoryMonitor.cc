@@ -0,0 +1,81 @@
+/*
+ * MemoryMonitor.cc
+ *
+ *  Created on: Jul 22, 2024
+ *      Author: pramita
+ */
+
+#include "MemoryMonitor.h"
+
+#include <sys/resource.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace omnetpp;
+
+Define_Module(MemoryMonitor);
+
+void MemoryMonitor::handleMessage(cMessage *msg)
+{
+    throw cRuntimeError("MemoryMonitor does not receive messages");
+}
+
+void MemoryMonitor::collect(cModule *module, std::map<std::string, TypeFootprint>& footprints) const
+{
+    for (cModule::SubmoduleIterator it(module); !it.end(); ++it) {
+        if (MemoryAccountable *accountable = dynamic_cast<MemoryAccountable *>(*it)) {
+            TypeFootprint& footprint = footprints[(*it)->getClassName()];
+            footprint.numModules++;
+            footprint.bytes += accountable->getMemoryFootprint();
+        }
+        collect(*it, footprints);
+    }
+}
+
+void MemoryMonitor::finish()
+{
+    std::map<std::string, TypeFootprint> footprints;
+    collect(getSimulation()->getSystemModule(), footprints);
+
+    size_t totalBytes = 0;
+    long totalModules = 0;
+    for (const auto& entry : footprints) {
+        const TypeFootprint& footprint = entry.second;
+        recordScalar((entry.first + ":modules").c_str(), footprint.numModules);
+        recordScalar((entry.first + ":stateBytes").c_str(), footprint.bytes, "B");
+        recordScalar((entry.first + ":stateBytesPerModule").c_str(), static_cast<double>(footprint.bytes) / footprint.numModules, "B");
+        totalBytes += footprint.bytes;
+        totalModules += footprint.numModules;
+    }
+    recordScalar("stateBytes", totalBytes, "B");
+    if (totalModules > 0)
+        recordScalar("stateBytesPerModule", static_cast<double>(totalBytes) / totalModules, "B");
+    recordScalar("heapInUse", getHeapInUse(), "B");
+    recordScalar("peakRss", getPeakRss(), "B");
+}
+
+size_t MemoryMonitor::getHeapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#elif defined(__GLIBC__)
+    struct mallinfo info = mallinfo();
+    return static_cast<unsigned int>(info.uordblks) + static_cast<unsigned int>(info.hblkhd);
+#else
+    return 0;
+#endif
+}
+
+size_t MemoryMonitor::getPeakRss()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss; // Bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // Kilobytes on Linux
+#endif
+}
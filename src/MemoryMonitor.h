@@ -0,0 +1,53 @@
+/*
+ * MemoryMonitor.h
+ *
+ *  Created on: Jul 22, 2024
+ *      Author: pramita
+ */
+
+#ifndef MEMORYMONITOR_H_
+#define MEMORYMONITOR_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <omnetpp.h>
+
+// Implemented by modules that report how much memory their state takes
+class MemoryAccountable {
+public:
+    virtual ~MemoryAccountable() {}
+    // Bytes of the module object plus the heap memory owned by its members;
+    // the kernel's own allocations (gates, parameters) are not included
+    virtual size_t getMemoryFootprint() const = 0;
+};
+
+// Heap bytes of standard containers as allocated by libstdc++; node based
+// containers are estimated with the size of their nodes
+template <class T>
+size_t heapBytes(const std::vector<T>& v) { return v.capacity() * sizeof(T); }
+template <class K, class V>
+size_t heapBytes(const std::map<K, V>& m) { return m.size() * (sizeof(std::pair<const K, V>) + 4 * sizeof(void *)); }
+
+// Records at the end of the run the state bytes per module type, summed over
+// all MemoryAccountable modules of the network, together with the heap in
+// use and the peak resident set size of the process.
+class MemoryMonitor : public omnetpp::cSimpleModule {
+protected:
+    struct TypeFootprint {
+        long numModules = 0;
+        size_t bytes = 0;
+    };
+
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+    virtual void finish() override;
+    virtual void collect(omnetpp::cModule *module, std::map<std::string, TypeFootprint>& footprints) const;
+
+public:
+    // Bytes allocated with malloc/new and not freed, 0 where unknown
+    static size_t getHeapInUse();
+    // Peak resident set size in bytes, 0 where unknown
+    static size_t getPeakRss();
+};
+
+#endif /* MEMORYMONITOR_H_ */
@@ -0,0 +1,163 @@
+/*
+ * MetricsExporter.cc
+ *
+ *  Created on: Aug 19, 2024
+ *      Author: pramita
+ */
+
+#include "MetricsExporter.h"
+#include "MemoryMonitor.h"
+
+#include <stdio.h>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+using namespace omnetpp;
+
+Define_Module(MetricsExporter);
+
+MetricsExporter::~MetricsExporter()
+{
+    cancelAndDelete(exportMsg);
+}
+
+void MetricsExporter::initialize()
+{
+    exportInterval = par("exportInterval");
+    minWallInterval = par("minWallInterval").doubleValue();
+    metricsFile = par("metricsFile").stdstringValue();
+    if (exportInterval <= 0)
+        return;
+    if (metricsFile.empty())
+        throw cRuntimeError("metricsFile must be set when exportInterval is positive");
+
+    cConfigurationEx *config = getEnvir()->getConfigEx();
+    runLabels = "config=\"" + escapeLabel(config->getActiveConfigName()) + "\",run=\"" + std::to_string(config->getActiveRunNumber()) + "\"";
+    startWallTime = lastWriteWallTime = Clock::now();
+    exportMsg = new cMessage("exportMetrics");
+    scheduleAt(simTime() + exportInterval, exportMsg);
+}
+
+void MetricsExporter::handleMessage(cMessage *msg)
+{
+    if (msg != exportMsg)
+        throw cRuntimeError("MetricsExporter does not receive messages");
+
+    if (std::chrono::duration<double>(Clock::now() - lastWriteWallTime).count() >= minWallInterval)
+        writeSnapshot(false);
+    // The timer alone must not keep a run going that has nothing left to do
+    if (getSimulation()->getFES()->getLength() > 0)
+        scheduleAt(simTime() + exportInterval, exportMsg);
+}
+
+void MetricsExporter::collect(cModule *module, std::map<std::string, Family>& families) const
+{
+    std::vector<MetricsProvider::Metric> metrics;
+    for (cModule::SubmoduleIterator it(module); !it.end(); ++it) {
+        if (MetricsProvider *provider = dynamic_cast<MetricsProvider *>(*it)) {
+            metrics.clear();
+            provider->collectMetrics(metrics);
+            std::string path = (*it)->getFullPath();
+            for (const MetricsProvider::Metric& metric : metrics) {
+                Family& family = families[metric.name];
+                family.help = metric.help;
+                family.counter = metric.counter;
+                family.samples.emplace_back(path, metric.value);
+            }
+        }
+        collect(*it, families);
+    }
+}
+
+void MetricsExporter::writeSnapshot(bool finished)
+{
+    Clock::time_point now = Clock::now();
+    double wallTime = std::chrono::duration<double>(now - startWallTime).count();
+    double sinceLastWrite = std::chrono::duration<double>(now - lastWriteWallTime).count();
+    int64_t events = getSimulation()->getEventNumber();
+
+    // Progress of the run itself, with an empty module path
+    std::map<std::string, Family> families;
+    auto add = [&families](const char *name, const char *help, bool counter, double value) {
+        Family& family = families[name];
+        family.help = help;
+        family.counter = counter;
+        family.samples.emplace_back(std::string(), value);
+    };
+    add("sim_events_total", "Events processed", true, static_cast<double>(events));
+    add("sim_events_per_second", "Events per wall-clock second since the previous snapshot", false,
+        sinceLastWrite > 0 ? (events - lastWriteEvents) / sinceLastWrite : 0);
+    add("sim_time_seconds", "Simulated time", false, SIMTIME_DBL(simTime()));
+    add("sim_wall_time_seconds", "Wall-clock time since the network was set up", false, wallTime);
+    add("sim_speed_ratio", "Simulated seconds per wall-clock second since the start", false,
+        wallTime > 0 ? SIMTIME_DBL(simTime()) / wallTime : 0);
+    add("sim_scheduled_events", "Length of the future event set", false, getSimulation()->getFES()->getLength());
+    add("sim_heap_bytes", "Heap in use, 0 where unknown", false, static_cast<double>(MemoryMonitor::getHeapInUse()));
+    add("sim_peak_rss_bytes", "Peak resident set size, 0 where unknown", false, static_cast<double>(MemoryMonitor::getPeakRss()));
+    add("sim_finished", "1 once the run has finished", false, finished ? 1 : 0);
+    add("sim_snapshot_timestamp_seconds", "Unix time of this snapshot; a stale value means a stuck run", false,
+        std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count());
+    collect(getSimulation()->getSystemModule(), families);
+
+    std::ostringstream out;
+    for (const auto& entry : families) {
+        const Family& family = entry.second;
+        out << "# HELP " << entry.first << " " << family.help << "\n";
+        out << "# TYPE " << entry.first << " " << (family.counter ? "counter" : "gauge") << "\n";
+        for (const auto& sample : family.samples) {
+            out << entry.first << "{" << runLabels;
+            if (!sample.first.empty())
+                out << ",module=\"" << escapeLabel(sample.first) << "\"";
+            out << "} " << formatValue(sample.second) << "\n";
+        }
+    }
+
+    // Replaced in one step, so that readers always see a complete snapshot
+    std::string tmpFile = metricsFile + ".tmp";
+    std::ofstream file(tmpFile, std::ios::trunc);
+    if (!file)
+        throw cRuntimeError("Cannot open metrics file '%s'", tmpFile.c_str());
+    file << out.str();
+    file.close();
+    if (!file || rename(tmpFile.c_str(), metricsFile.c_str()) != 0)
+        throw cRuntimeError("Cannot write metrics file '%s'", metricsFile.c_str());
+
+    numSnapshots++;
+    lastWriteWallTime = now;
+    lastWriteEvents = events;
+}
+
+std::string MetricsExporter::escapeLabel(const std::string& value)
+{
+    std::string escaped;
+    for (char c : value) {
+        if (c == '\\' || c == '"')
+            escaped += '\\';
+        if (c == '\n')
+            escaped += "\\n";
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+std::string MetricsExporter::formatValue(double value)
+{
+    if (std::isnan(value))
+        return "NaN";
+    if (std::isinf(value))
+        return value > 0 ? "+Inf" : "-Inf";
+    std::ostringstream out;
+    out.precision(15);
+    out << value;
+    return out.str();
+}
+
+void MetricsExporter::finish()
+{
+    if (exportMsg == nullptr)
+        return;
+    writeSnapshot(true);
+    recordScalar("metricsSnapshots", numSnapshots);
+}
@@ -0,0 +1,80 @@
+/*
+ * MetricsExporter.h
+ *
+ *  Created on: Aug 19, 2024
+ *      Author: pramita
+ */
+
+#ifndef METRICSEXPORTER_H_
+#define METRICSEXPORTER_H_
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <omnetpp.h>
+
+// Implemented by modules that publish key results while the run is in
+// progress; only called when the MetricsExporter writes a snapshot
+class MetricsProvider {
+public:
+    struct Metric {
+        const char *name;     // Prometheus metric name, e.g. "hub_forwarded_ratio"
+        const char *help;
+        double value;
+        bool counter;         // Only ever increases; otherwise a gauge
+    };
+
+    virtual ~MetricsProvider() {}
+    virtual void collectMetrics(std::vector<Metric>& metrics) const = 0;
+};
+
+// Publishes the progress of the run for monitoring long sweeps: events per
+// second, simulated and wall-clock time, length of the future event set,
+// heap in use and the metrics of all MetricsProvider modules, labelled with
+// the module path. Snapshots are written in the Prometheus text format to
+// metricsFile, through a temporary file that is renamed over it, so a
+// reader (e.g. the textfile collector of the node exporter) never sees a
+// partial snapshot.
+//
+// A timer checks every exportInterval of simulated time whether
+// minWallInterval of wall-clock time has passed since the last snapshot,
+// so the files are written at a fixed real-time rate whatever the speed of
+// the run. With exportInterval = 0s the module schedules nothing and costs
+// nothing; when enabled its timer events change the event fingerprints.
+class MetricsExporter : public omnetpp::cSimpleModule {
+protected:
+    typedef std::chrono::steady_clock Clock;
+    struct Family {
+        const char *help;
+        bool counter;
+        std::vector<std::pair<std::string, double>> samples; // Module path, value
+    };
+
+    omnetpp::simtime_t exportInterval;
+    double minWallInterval;       // s
+    std::string metricsFile;
+    std::string runLabels;        // config="...",run="..."
+    omnetpp::cMessage *exportMsg = nullptr;
+
+    Clock::time_point startWallTime;
+    Clock::time_point lastWriteWallTime;
+    int64_t lastWriteEvents = 0;
+    long numSnapshots = 0;
+
+    virtual void initialize() override;
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+    virtual void finish() override;
+
+    virtual void collect(omnetpp::cModule *module, std::map<std::string, Family>& families) const;
+    virtual void writeSnapshot(bool finished);
+
+    static std::string escapeLabel(const std::string& value);
+    static std::string formatValue(double value);
+
+public:
+    virtual ~MetricsExporter();
+};
+
+#endif /* METRICSEXPORTER_H_ */
@@ -0,0 +1,216 @@
+/*
+ * MobilityManager.cc
+ *
+ *  Created on: Jul 29, 2024
+ *      Author: pramita
+ */
+
+#include "MobilityManager.h"
+#include "CheckpointManager.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace omnetpp;
+
+Define_Module(MobilityManager);
+
+MobilityManager::~MobilityManager()
+{
+    cancelAndDelete(updateMsg);
+}
+
+MobilityManager *MobilityManager::find()
+{
+    cModule *network = getSimulation()->getSystemModule();
+    return network ? dynamic_cast<MobilityManager *>(network->getSubmodule("mobility")) : nullptr;
+}
+
+void MobilityManager::initialize()
+{
+    updateInterval = par("updateInterval");
+    gaitPeriod = par("gaitPeriod").doubleValue();
+    referenceDistance = par("referenceDistance").doubleValue();
+    referencePathLoss = par("referencePathLoss").doubleValue();
+    minDistance = par("minDistance").doubleValue();
+    updateBitErrorRate = par("updateBitErrorRate");
+    txPower = par("txPower").doubleValue();
+    noiseFloor = par("noiseFloor").doubleValue();
+    if (gaitPeriod <= 0)
+        throw cRuntimeError("gaitPeriod must be positive");
+
+    discoverNodes();
+    EV << "Mobility of " << nodes.size() << " nodes, " << movingNodes.size() << " moving, on " << links.size() << " links\n";
+
+    // Without updates the links keep the distances given in the NED file
+    if (updateInterval > 0)
+        updateMsg = new cMessage("mobilityUpdate");
+    if (CheckpointManager::restore(this) || updateMsg == nullptr)
+        return;
+    moveNodes(0);
+    for (Link& link : links)
+        updateLink(link);
+    scheduleAt(simTime() + updateInterval, updateMsg);
+}
+
+void MobilityManager::discoverNodes()
+{
+    if (discovered)
+        return;
+    // The module tree is complete before any module initializes
+    discovered = true;
+    discover(getSimulation()->getSystemModule());
+    for (size_t i = 0; i < nodes.size(); i++)
+        addLinks(i);
+}
+
+void MobilityManager::discover(cModule *module)
+{
+    for (cModule::SubmoduleIterator it(module); !it.end(); ++it) {
+        cModule *submodule = *it;
+        if (submodule->hasPar("bodyX")) {
+            Node node;
+            node.module = submodule;
+            node.rest = {submodule->par("bodyX").doubleValue(), submodule->par("bodyY").doubleValue(), submodule->par("bodyZ").doubleValue()};
+            if (module->hasPar("originX")) {
+                node.rest.x += module->par("originX").doubleValue();
+                node.rest.y += module->par("originY").doubleValue();
+                node.rest.z += module->par("originZ").doubleValue();
+            }
+            node.swing = {submodule->par("swingX").doubleValue(), submodule->par("swingY").doubleValue(), submodule->par("swingZ").doubleValue()};
+            node.phase = submodule->par("swingPhase").doubleValue() * M_PI / 180;
+            node.position = node.rest;
+            if (node.swing.x != 0 || node.swing.y != 0 || node.swing.z != 0)
+                movingNodes.push_back(nodes.size());
+            nodeIndexOf[submodule->getId()] = nodes.size();
+            nodes.push_back(node);
+        }
+        discover(submodule);
+    }
+}
+
+void MobilityManager::addLinks(int nodeIndex)
+{
+    cModule *module = nodes[nodeIndex].module;
+    for (int i = 0; i < module->gateSize("output_gate"); i++) {
+        cGate *gate = module->gate("output_gate", i);
+        cDatarateChannel *channel = dynamic_cast<cDatarateChannel *>(gate->getChannel());
+        if (channel == nullptr || !channel->hasPar("distance"))
+            continue;
+        auto to = nodeIndexOf.find(gate->getPathEndGate()->getOwnerModule()->getId());
+        if (to == nodeIndexOf.end())
+            continue;
+        Link link;
+        link.channel = channel;
+        link.from = nodeIndex;
+        link.to = to->second;
+        link.exponent = channel->par("alpha").doubleValue();
+        link.systemLoss = channel->par("systemLoss").doubleValue();
+        link.distance = channel->par("distance").doubleValue();
+        nodes[link.from].links.push_back(links.size());
+        nodes[link.to].links.push_back(links.size());
+        links.push_back(link);
+    }
+}
+
+void MobilityManager::handleMessage(cMessage *msg)
+{
+    if (msg != updateMsg)
+        throw cRuntimeError("MobilityManager does not receive messages");
+
+    // Only the links of nodes that moved; a link between two moving nodes is recomputed once
+    numUpdates++;
+    moveNodes(timeBase + SIMTIME_DBL(simTime()));
+    for (int nodeIndex : movingNodes) {
+        for (int linkIndex : nodes[nodeIndex].links) {
+            Link& link = links[linkIndex];
+            if (link.updatedAt == numUpdates)
+                continue;
+            link.updatedAt = numUpdates;
+            updateLink(link);
+            numLinkUpdates++;
+            pathLossSum += link.pathLoss;
+        }
+    }
+    scheduleAt(simTime() + updateInterval, updateMsg);
+}
+
+void MobilityManager::moveNodes(double motionTime)
+{
+    double angle = 2 * M_PI * motionTime / gaitPeriod;
+    for (int nodeIndex : movingNodes) {
+        Node& node = nodes[nodeIndex];
+        double s = std::sin(angle + node.phase);
+        node.position.x = node.rest.x + node.swing.x * s;
+        node.position.y = node.rest.y + node.swing.y * s;
+        node.position.z = node.rest.z + node.swing.z * s;
+    }
+}
+
+void MobilityManager::updateLink(Link& link)
+{
+    const Vector3& a = nodes[link.from].position;
+    const Vector3& b = nodes[link.to].position;
+    double dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+    link.distance = std::max(minDistance, std::sqrt(dx * dx + dy * dy + dz * dz));
+    link.pathLoss = getPathLoss(link.distance, link.exponent) + link.systemLoss;
+    link.channel->par("distance").setDoubleValue(link.distance);
+    if (updateBitErrorRate)
+        link.channel->setBitErrorRate(bitErrorRate(txPower - link.pathLoss - noiseFloor));
+}
+
+double MobilityManager::getPathLoss(double distance, double exponent) const
+{
+    return referencePathLoss + 10 * exponent * std::log10(std::max(minDistance, distance) / referenceDistance);
+}
+
+double MobilityManager::bitErrorRate(double snrDb)
+{
+    return 0.5 * std::erfc(std::sqrt(std::pow(10, snrDb / 10)));
+}
+
+bool MobilityManager::getPosition(cModule *module, Vector3& position)
+{
+    discoverNodes();
+    auto it = nodeIndexOf.find(module->getId());
+    if (it == nodeIndexOf.end())
+        return false;
+    position = nodes[it->second].position;
+    return true;
+}
+
+void MobilityManager::saveState(CheckpointWriter& writer)
+{
+    writer.putDouble(timeBase + SIMTIME_DBL(simTime()));
+    writer.putLong(numUpdates);
+    writer.putLong(numLinkUpdates);
+    writer.putDouble(pathLossSum);
+    writer.putDouble(CheckpointManager::remainingTime(updateMsg));
+}
+
+void MobilityManager::loadState(CheckpointReader& reader)
+{
+    // Positions and link distances follow from the motion time
+    timeBase = reader.getDouble();
+    numUpdates = reader.getLong();
+    numLinkUpdates = reader.getLong();
+    pathLossSum = reader.getDouble();
+    double remaining = reader.getDouble();
+    if (updateMsg == nullptr)
+        return; // Restored without mobility: the links keep their NED distances
+    moveNodes(timeBase);
+    for (Link& link : links)
+        updateLink(link);
+    if (remaining >= 0)
+        scheduleAt(simTime() + remaining, updateMsg);
+}
+
+void MobilityManager::finish()
+{
+    if (updateMsg == nullptr)
+        return;
+    recordScalar("mobilityUpdates", numUpdates);
+    recordScalar("linkUpdates", numLinkUpdates);
+    if (numLinkUpdates > 0)
+        recordScalar("pathLoss:mean", pathLossSum / numLinkUpdates, "dB");
+}
@@ -0,0 +1,109 @@
+/*
+ * MobilityManager.h
+ *
+ *  Created on: Jul 29, 2024
+ *      Author: pramita
+ */
+
+#ifndef MOBILITYMANAGER_H_
+#define MOBILITYMANAGER_H_
+
+#include <map>
+#include <vector>
+#include <omnetpp.h>
+#include "Checkpoint.h"
+
+// Moves the body nodes and keeps the distances of the links between them up
+// to date. Every node has a rest position on the body (its posture) and may
+// swing periodically around it with the gait, e.g. a sensor on the wrist
+// or ankle while walking. Rest positions are relative to the origin of the
+// enclosing module if it has one (the body's place in the network). One
+// timer of the manager moves all nodes every updateInterval; only the links
+// with a moved end are recomputed. For each of those the manager sets the
+// channel's distance parameter and caches the log-distance path loss, and
+// with updateBitErrorRate it also sets the channel's bit error rate from
+// the resulting SNR.
+class MobilityManager : public omnetpp::cSimpleModule, public Checkpointable {
+public:
+    struct Vector3 {
+        double x, y, z;
+    };
+
+protected:
+    struct Node {
+        omnetpp::cModule *module;
+        Vector3 rest;             // cm
+        Vector3 swing;            // Amplitude of the gait motion, cm
+        double phase;             // rad
+        Vector3 position;
+        std::vector<int> links;   // Indices into links of the links this node is an end of
+    };
+    struct Link {
+        omnetpp::cDatarateChannel *channel;
+        int from, to;             // Indices into nodes
+        double exponent;          // Path loss exponent of the channel (its alpha)
+        double systemLoss;        // dB
+        double distance = 0;      // cm
+        double pathLoss = 0;      // dB
+        long updatedAt = -1;      // Update round of the last recomputation
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Link> links;
+    std::vector<int> movingNodes; // Nodes with a non-zero swing
+    std::map<int, int> nodeIndexOf; // Module id -> index into nodes
+    bool discovered = false;
+
+    omnetpp::simtime_t updateInterval;
+    double gaitPeriod;            // s
+    double referenceDistance;     // cm
+    double referencePathLoss;     // dB at referenceDistance
+    double minDistance;           // cm
+    bool updateBitErrorRate = false;
+    double txPower;               // dBm
+    double noiseFloor;            // dBm
+    omnetpp::cMessage *updateMsg = nullptr;
+
+    // Motion time at t=0; a restored run continues the gait where the checkpoint left it
+    double timeBase = 0;
+    long numUpdates = 0;
+    long numLinkUpdates = 0;
+    double pathLossSum = 0;       // Over all link updates
+
+    virtual void initialize() override;
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+    virtual void finish() override;
+
+    // Finds the nodes and links on first use, which may be before this
+    // module's initialize() if a node transmits from its own
+    virtual void discoverNodes();
+    virtual void discover(omnetpp::cModule *module);
+    virtual void addLinks(int nodeIndex);
+    virtual void moveNodes(double motionTime);
+    virtual void updateLink(Link& link);
+    // Bit error rate of O-QPSK/BPSK at the given SNR, 0.5 erfc(sqrt(snr))
+    static double bitErrorRate(double snrDb);
+
+    // Checkpointable
+    virtual void saveState(CheckpointWriter& writer) override;
+    virtual void loadState(CheckpointReader& reader) override;
+
+public:
+    virtual ~MobilityManager();
+
+    // Returns the manager of the current network, or nullptr if there is none
+    static MobilityManager *find();
+
+    // Whether the nodes move at all (updateInterval > 0)
+    bool isActive() const { return updateMsg != nullptr; }
+    // Current position of a body node in cm; false if the module is not one
+    bool getPosition(omnetpp::cModule *module, Vector3& position);
+
+    // Link budget shared by the links and the SharedMedium: log-distance
+    // path loss in dB at the given distance in cm, transmit power and noise in dBm
+    double getPathLoss(double distance, double exponent) const;
+    double getTxPower() const { return txPower; }
+    double getNoiseFloor() const { return noiseFloor; }
+};
+
+#endif /* MOBILITYMANAGER_H_ */
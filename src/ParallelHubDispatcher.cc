@@ -0,0 +1,106 @@
+/*
+ * ParallelHubDispatcher.cc
+ *
+ *  Created on: Jun 3, 2024
+ *      Author: pramita
+ */
+
+#include "ParallelHubDispatcher.h"
+
+#include <limits.h>
+#include <algorithm>
+
+using namespace omnetpp;
+
+Define_Module(ParallelHubDispatcher);
+
+ParallelHubDispatcher::~ParallelHubDispatcher()
+{
+    cancelAndDelete(flushMsg);
+}
+
+ParallelHubDispatcher *ParallelHubDispatcher::find()
+{
+    cModule *network = getSimulation()->getSystemModule();
+    return network ? dynamic_cast<ParallelHubDispatcher *>(network->getSubmodule("hubDispatcher")) : nullptr;
+}
+
+void ParallelHubDispatcher::initialize()
+{
+    minParallelClients = par("minParallelHubs");
+    flushMsg = new cMessage("flushHubBatch");
+    // Run after all other events of the same time instant, so that every
+    // sample arriving at that instant is part of the batch; checkpoints run
+    // later still (see CheckpointManager)
+    flushMsg->setSchedulingPriority(SHRT_MAX - 1);
+}
+
+void ParallelHubDispatcher::enqueue(cModule *module, ConcurrentFilterClient *client, cMessage *msg,
+                                    cModule *sender, double receivedValue)
+{
+    Enter_Method_Silent("enqueue");
+    if (pool == nullptr)
+        pool.reset(new WorkStealingPool(par("numThreads")));
+
+    ClientQueue& queue = queues[module->getId()];
+    queue.client = client;
+    queue.module = module;
+    if (queue.samples.empty())
+        activeQueues.push_back(&queue);
+    queue.samples.push_back(PendingSample{msg, sender, sender->getName(), receivedValue, 0, false});
+    numSamples++;
+
+    if (!flushMsg->isScheduled())
+        scheduleAt(simTime(), flushMsg);
+}
+
+void ParallelHubDispatcher::handleMessage(cMessage *msg)
+{
+    if (msg != flushMsg)
+        throw cRuntimeError("Unexpected message %s", msg->getName());
+    flush();
+}
+
+void ParallelHubDispatcher::flush()
+{
+    numFlushes++;
+
+    // Only the hubs that received samples at this instant, in module id order
+    std::sort(activeQueues.begin(), activeQueues.end(),
+              [](const ClientQueue *a, const ClientQueue *b) { return a->module->getId() < b->module->getId(); });
+
+    // Filter step: one task per active hub
+    for (ClientQueue *queue : activeQueues) {
+        tasks.push_back([queue] {
+            for (PendingSample& sample : queue->samples)
+                sample.known = queue->client->filterConcurrently(sample.senderName, sample.receivedValue, sample.filteredValue);
+        });
+    }
+    if (static_cast<int>(tasks.size()) >= minParallelClients) {
+        numParallelFlushes++;
+        pool->run(tasks);
+    } else {
+        for (auto& task : tasks)
+            task();
+        tasks.clear();
+    }
+
+    // Merge step on the simulation thread, in module id and arrival order
+    for (ClientQueue *queue : activeQueues) {
+        for (PendingSample& sample : queue->samples)
+            queue->client->applyFilterResult(sample.msg, sample.sender, sample.receivedValue, sample.filteredValue, sample.known);
+        queue->samples.clear();
+    }
+    activeQueues.clear();
+}
+
+void ParallelHubDispatcher::finish()
+{
+    if (numFlushes == 0)
+        return;
+    recordScalar("hubBatches", numFlushes);
+    recordScalar("parallelHubBatches", numParallelFlushes);
+    recordScalar("meanSamplesPerBatch", static_cast<double>(numSamples) / numFlushes);
+    if (pool != nullptr)
+        recordScalar("threads", pool->getNumThreads());
+}
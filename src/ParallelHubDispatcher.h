@@ -0,0 +1,86 @@
+/*
+ * ParallelHubDispatcher.h
+ *
+ *  Created on: Jun 3, 2024
+ *      Author: pramita
+ */
+
+#ifndef PARALLELHUBDISPATCHER_H_
+#define PARALLELHUBDISPATCHER_H_
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <omnetpp.h>
+#include "WorkStealingPool.h"
+
+// Implemented by modules whose per-sample filtering can run on a worker
+// thread. filterConcurrently() must only touch the module's own filter state
+// and never call into the simulation kernel; applyFilterResult() is called
+// afterwards on the simulation thread, in the context of the module.
+class ConcurrentFilterClient {
+public:
+    virtual ~ConcurrentFilterClient() {}
+    virtual bool filterConcurrently(const char *senderName, double receivedValue, double& filteredValue) = 0;
+    virtual void applyFilterResult(omnetpp::cMessage *msg, omnetpp::cModule *sender, double receivedValue,
+                                   double filteredValue, bool known) = 0;
+};
+
+// Collects the samples that arrive at the hubs within one simulation time
+// instant and filters them in one go: the samples of each hub form one task
+// (keeping per-hub arrival order), the tasks run on a work-stealing thread
+// pool, and the results are applied in hub module id order so that runs are
+// reproducible regardless of the number of threads.
+//
+// Compared with filtering inline, every hub still filters the same samples
+// in the same order, so its filter statistics (PredictionError,
+// samplesForwarded, the warm-up and steady-state scalars) are unchanged,
+// provided the sensor values do not depend on the event order (sensors
+// sampling at start-up, or perModuleRng).
+// The forwards are deferred to the flush event and merged in module id
+// order, though, which changes the event order, the event numbers and the
+// fingerprint, and with them the arrival order at the OBN and the OBN's
+// results (its filters, freshness statistics and draws from a shared RNG).
+class ParallelHubDispatcher : public omnetpp::cSimpleModule {
+protected:
+    struct PendingSample {
+        omnetpp::cMessage *msg;
+        omnetpp::cModule *sender;
+        const char *senderName;
+        double receivedValue;
+        double filteredValue;
+        bool known;
+    };
+    struct ClientQueue {
+        ConcurrentFilterClient *client;
+        omnetpp::cModule *module;
+        std::vector<PendingSample> samples;
+    };
+
+    std::unique_ptr<WorkStealingPool> pool;
+    std::map<int, ClientQueue> queues; // Keyed by module id; kept between flushes to reuse the sample vectors
+    std::vector<ClientQueue *> activeQueues; // Queues with samples at the current time instant
+    std::vector<WorkStealingPool::Task> tasks;
+    omnetpp::cMessage *flushMsg = nullptr;
+    int minParallelClients = 2;
+    long numFlushes = 0;
+    long numParallelFlushes = 0;
+    long numSamples = 0;
+
+    virtual void initialize() override;
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+    virtual void finish() override;
+    virtual void flush();
+
+public:
+    virtual ~ParallelHubDispatcher();
+
+    // Returns the dispatcher of the current network, or nullptr if there is none
+    static ParallelHubDispatcher *find();
+
+    // Queues a received sample of the calling module for the flush at the current time
+    void enqueue(omnetpp::cModule *module, ConcurrentFilterClient *client, omnetpp::cMessage *msg,
+                 omnetpp::cModule *sender, double receivedValue);
+};
+
+#endif /* PARALLELHUBDISPATCHER_H_ */
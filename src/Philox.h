@@ -0,0 +1,91 @@
+/*
+ * Philox.h
+ *
+ *  Created on: Jun 10, 2024
+ *      Author: pramita
+ */
+
+#ifndef PHILOX_H_
+#define PHILOX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3", SC'11). Block n of a stream is a pure
+// function of the 64-bit key, the 64-bit block number n and the 64-bit
+// stream number held in the upper counter words, so a stream can be
+// positioned anywhere in O(1) and independent streams need nothing but
+// different keys or stream numbers. Plain C++ so that the fastpath pipeline
+// can use it too.
+class Philox4x32 {
+public:
+    static const int ROUNDS = 10;
+    static const int MAX_BATCH_BLOCKS = 16;
+
+    // Writes the 4 words of block 'block' of the stream with the given key to out
+    static void generateBlock(const uint32_t key[2], uint64_t block, uint32_t out[4], uint64_t stream = 0) {
+        generate(key, block, 1, out, stream);
+    }
+
+    // Writes numBlocks consecutive blocks (4 words each) starting at firstBlock.
+    // The blocks are computed lane by lane over small arrays so that the
+    // compiler can vectorise the rounds.
+    static void generate(const uint32_t key[2], uint64_t firstBlock, size_t numBlocks, uint32_t *out, uint64_t stream = 0) {
+        while (numBlocks > 0) {
+            size_t n = numBlocks < MAX_BATCH_BLOCKS ? numBlocks : MAX_BATCH_BLOCKS;
+            uint32_t c0[MAX_BATCH_BLOCKS], c1[MAX_BATCH_BLOCKS], c2[MAX_BATCH_BLOCKS], c3[MAX_BATCH_BLOCKS];
+            for (size_t i = 0; i < n; i++) {
+                uint64_t counter = firstBlock + i;
+                c0[i] = static_cast<uint32_t>(counter);
+                c1[i] = static_cast<uint32_t>(counter >> 32);
+                c2[i] = static_cast<uint32_t>(stream);
+                c3[i] = static_cast<uint32_t>(stream >> 32);
+            }
+            uint32_t k0 = key[0], k1 = key[1];
+            for (int round = 0; round < ROUNDS; round++) {
+                for (size_t i = 0; i < n; i++) {
+                    uint64_t p0 = static_cast<uint64_t>(M0) * c0[i];
+                    uint64_t p1 = static_cast<uint64_t>(M1) * c2[i];
+                    uint32_t x0 = static_cast<uint32_t>(p1 >> 32) ^ c1[i] ^ k0;
+                    uint32_t x2 = static_cast<uint32_t>(p0 >> 32) ^ c3[i] ^ k1;
+                    c1[i] = static_cast<uint32_t>(p1);
+                    c3[i] = static_cast<uint32_t>(p0);
+                    c0[i] = x0;
+                    c2[i] = x2;
+                }
+                k0 += W0;
+                k1 += W1;
+            }
+            for (size_t i = 0; i < n; i++) {
+                out[4 * i] = c0[i];
+                out[4 * i + 1] = c1[i];
+                out[4 * i + 2] = c2[i];
+                out[4 * i + 3] = c3[i];
+            }
+            firstBlock += n;
+            numBlocks -= n;
+            out += 4 * n;
+        }
+    }
+
+    // 64-bit FNV-1a; turns a module path into the two key words. With 64
+    // bits a collision among 100k modules has a probability of about 3e-10,
+    // against about one expected collision with 32 bits.
+    static uint64_t hash(const char *s) {
+        uint64_t h = 14695981039346656037ull;
+        for (; *s; s++) {
+            h ^= static_cast<unsigned char>(*s);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+private:
+    static const uint32_t M0 = 0xD2511F53;
+    static const uint32_t M1 = 0xCD9E8D57;
+    static const uint32_t W0 = 0x9E3779B9; // Golden ratio
+    static const uint32_t W1 = 0xBB67AE85; // sqrt(3) - 1
+};
+
+#endif /* PHILOX_H_ */
@@ -0,0 +1,126 @@
+/*
+ * PhiloxRng.cc
+ *
+ *  Created on: Jun 10, 2024
+ *      Author: pramita
+ */
+
+#include "PhiloxRng.h"
+#include "Checkpoint.h"
+
+using namespace omnetpp;
+
+Register_Class(PhiloxRng);
+
+PhiloxRng::PhiloxRng(uint32_t key0, uint32_t key1, uint64_t stream)
+{
+    _key[0] = key0;
+    _key[1] = key1;
+    _stream = stream;
+}
+
+PhiloxRng *PhiloxRng::forModule(cModule *module)
+{
+    int runNumber = getEnvir()->getConfigEx()->getActiveRunNumber();
+    uint64_t pathHash = Philox4x32::hash(module->getFullPath().c_str());
+    return new PhiloxRng(static_cast<uint32_t>(pathHash), static_cast<uint32_t>(pathHash >> 32), static_cast<uint64_t>(runNumber));
+}
+
+void PhiloxRng::initialize(int seedSet, int rngId, int numRngs, int parsimProcId, int parsimNumPartitions,
+                           cConfiguration *cfg)
+{
+    // Used as rng-class: one stream per (seed set, RNG id)
+    _key[0] = static_cast<uint32_t>(rngId);
+    _key[1] = static_cast<uint32_t>(seedSet);
+    _stream = 0;
+    seek(0);
+}
+
+void PhiloxRng::selfTest()
+{
+    // Known-answer test of Random123 for a zero key and counter
+    static const uint32_t expected[4] = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+    const uint32_t key[2] = {0, 0};
+    uint32_t block[4];
+    Philox4x32::generateBlock(key, 0, block);
+    for (int i = 0; i < 4; i++)
+        if (block[i] != expected[i])
+            throw cRuntimeError("PhiloxRng: selfTest() failed, please report this problem!");
+}
+
+void PhiloxRng::refill()
+{
+    Philox4x32::generate(_key, _next_block, BUFFER_BLOCKS, _buffer, _stream);
+    _next_block += BUFFER_BLOCKS;
+    _pos = 0;
+}
+
+void PhiloxRng::seek(unsigned long numbersDrawn)
+{
+    _next_block = static_cast<uint64_t>(numbersDrawn / BUFFER_SIZE) * BUFFER_BLOCKS;
+    refill();
+    _pos = static_cast<int>(numbersDrawn % BUFFER_SIZE);
+    numDrawn = numbersDrawn;
+}
+
+uint32_t PhiloxRng::intRand()
+{
+    if (_pos == BUFFER_SIZE)
+        refill();
+    numDrawn++;
+    return _buffer[_pos++];
+}
+
+uint32_t PhiloxRng::intRand(uint32_t n)
+{
+    if (n == 0)
+        throw cRuntimeError("PhiloxRng: intRand(n) called with n=0");
+
+    // Same rejection scheme as cMersenneTwister: mask to the smallest
+    // power of two above n-1 and retry
+    uint32_t used = n - 1;
+    used |= used >> 1;
+    used |= used >> 2;
+    used |= used >> 4;
+    used |= used >> 8;
+    used |= used >> 16;
+    uint32_t i;
+    do {
+        i = intRand() & used;
+    } while (i > n - 1);
+    return i;
+}
+
+double PhiloxRng::doubleRand()
+{
+    return intRand() * (1.0 / 4294967296.0);
+}
+
+double PhiloxRng::doubleRandNonz()
+{
+    return (intRand() + 0.5) * (1.0 / 4294967296.0);
+}
+
+double PhiloxRng::doubleRandIncl1()
+{
+    return intRand() * (1.0 / 4294967295.0);
+}
+
+void ModuleRng::configure(cModule *module, bool perModule)
+{
+    delete _own_rng;
+    _own_rng = perModule ? PhiloxRng::forModule(module) : nullptr;
+    _rng = perModule ? _own_rng : module->getRNG(0);
+}
+
+void ModuleRng::saveState(CheckpointWriter& writer) const
+{
+    writer.putLong(_own_rng ? _own_rng->getNumbersDrawn() : 0);
+}
+
+void ModuleRng::loadState(CheckpointReader& reader)
+{
+    unsigned long numbersDrawn = reader.getLong();
+    if (_own_rng)
+        _own_rng->seek(numbersDrawn);
+}
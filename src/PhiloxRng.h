@@ -0,0 +1,79 @@
+/*
+ * PhiloxRng.h
+ *
+ *  Created on: Jun 10, 2024
+ *      Author: pramita
+ */
+
+#ifndef PHILOXRNG_H_
+#define PHILOXRNG_H_
+
+#include <omnetpp.h>
+#include "Philox.h"
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// cRNG on top of Philox4x32. Numbers are produced in batches of BUFFER_SIZE
+// words; getNumbersDrawn() counts single words, and seek() repositions the
+// stream to any such count without generating the numbers in between.
+class PhiloxRng : public omnetpp::cRNG {
+private:
+    static const int BUFFER_BLOCKS = Philox4x32::MAX_BATCH_BLOCKS;
+    static const int BUFFER_SIZE = 4 * BUFFER_BLOCKS;
+
+    uint32_t _key[2];
+    uint64_t _stream;           // Upper counter words
+    uint64_t _next_block = 0;   // First block of the next batch
+    uint32_t _buffer[BUFFER_SIZE];
+    int _pos = BUFFER_SIZE;     // Next unused word of _buffer
+
+    void refill();
+
+public:
+    explicit PhiloxRng(uint32_t key0 = 0, uint32_t key1 = 0, uint64_t stream = 0);
+
+    // Stream of the given module: keyed by a 64-bit hash of its full path,
+    // with the run number as stream number, so that it does not depend on
+    // module ids or on the order of events
+    static PhiloxRng *forModule(omnetpp::cModule *module);
+
+    void seek(unsigned long numbersDrawn);
+
+    // cRNG
+    virtual void initialize(int seedSet, int rngId, int numRngs, int parsimProcId, int parsimNumPartitions,
+                            omnetpp::cConfiguration *cfg) override;
+    virtual void selfTest() override;
+    virtual uint32_t intRand() override;
+    virtual uint32_t intRandMax() override { return 0xffffffffu; }
+    virtual uint32_t intRand(uint32_t n) override;
+    virtual double doubleRand() override;
+    virtual double doubleRandNonz() override;
+    virtual double doubleRandIncl1() override;
+};
+
+// Random number source of a node: the module's RNG 0 by default, or its own
+// PhiloxRng stream when the perModuleRng parameter is set.
+class ModuleRng {
+private:
+    omnetpp::cRNG *_rng = nullptr;
+    PhiloxRng *_own_rng = nullptr;
+
+public:
+    ModuleRng() {}
+    ModuleRng(const ModuleRng&) = delete;
+    ModuleRng& operator=(const ModuleRng&) = delete;
+    ~ModuleRng() { delete _own_rng; }
+
+    void configure(omnetpp::cModule *module, bool perModule);
+    omnetpp::cRNG *get() const { return _rng; }
+
+    int intuniform(int a, int b) { return omnetpp::intuniform(_rng, a, b); }
+    double uniform(double a, double b) { return omnetpp::uniform(_rng, a, b); }
+
+    // Position of the module's own stream; RNG 0 is restored by the CheckpointManager
+    void saveState(CheckpointWriter& writer) const;
+    void loadState(CheckpointReader& reader);
+};
+
+#endif /* PHILOXRNG_H_ */
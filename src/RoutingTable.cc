@@ -0,0 +1,60 @@
+/*
+ * RoutingTable.cc
+ *
+ *  Created on: Jun 17, 2024
+ *      Author: pramita
+ */
+
+#include "RoutingTable.h"
+
+#include <deque>
+#include <set>
+
+using namespace omnetpp;
+
+void RoutingTable::build(cModule *node, const char *gateName)
+{
+    // Breadth-first search over the connections; every entry carries the
+    // output gate of 'node' on which the path started
+    struct Hop {
+        cModule *from;
+        int gateIndex;
+        int firstGate;
+        int hops;
+    };
+    _routes.clear();
+    std::set<cModule *> visited;
+    std::deque<Hop> pending;
+    visited.insert(node);
+    for (int i = 0; i < node->gateSize(gateName); i++)
+        pending.push_back(Hop{node, i, i, 1});
+
+    while (!pending.empty()) {
+        Hop hop = pending.front();
+        pending.pop_front();
+
+        cGate *end = hop.from->gate(gateName, hop.gateIndex)->getPathEndGate();
+        cModule *to = end ? end->getOwnerModule() : nullptr;
+        if (to == nullptr || !to->hasPar("nodeId") || !visited.insert(to).second)
+            continue;
+
+        _routes[to->par("nodeId").intValue()] = Route{hop.firstGate, hop.hops};
+        for (int i = 0; i < to->gateSize(gateName); i++)
+            pending.push_back(Hop{to, i, hop.firstGate, hop.hops + 1});
+    }
+}
+
+int RoutingTable::lookup(int destination) const
+{
+    auto it = _routes.find(destination);
+    return it == _routes.end() ? -1 : it->second.gateIndex;
+}
+
+std::vector<int> RoutingTable::getDestinations(int hops) const
+{
+    std::vector<int> destinations;
+    for (const auto& entry : _routes)
+        if (hops < 0 || entry.second.hops == hops)
+            destinations.push_back(entry.first);
+    return destinations;
+}
@@ -0,0 +1,37 @@
+/*
+ * RoutingTable.h
+ *
+ *  Created on: Jun 17, 2024
+ *      Author: pramita
+ */
+
+#ifndef ROUTINGTABLE_H_
+#define ROUTINGTABLE_H_
+
+#include <map>
+#include <vector>
+#include <omnetpp.h>
+
+// Next hop of a node towards every other node of its cluster: maps the
+// nodeId of each node reachable through the node's output gates to the gate
+// index of the first hop on a shortest path. Built once from the static
+// topology, so a lookup is a single map access.
+class RoutingTable {
+private:
+    struct Route {
+        int gateIndex;
+        int hops;
+    };
+    std::map<int, Route> _routes;
+
+public:
+    void build(omnetpp::cModule *node, const char *gateName = "output_gate");
+
+    // Gate index towards the destination, or -1 if it is not reachable
+    int lookup(int destination) const;
+    // Reachable nodeIds, optionally only those the given number of hops away
+    std::vector<int> getDestinations(int hops = -1) const;
+    int size() const { return static_cast<int>(_routes.size()); }
+};
+
+#endif /* ROUTINGTABLE_H_ */
@@ -0,0 +1,68 @@
+/*
+ * SampleBatch.h
+ *
+ *  Created on: Apr 15, 2024
+ *      Author: pramita
+ */
+
+#ifndef SAMPLEBATCH_H_
+#define SAMPLEBATCH_H_
+
+#include <vector>
+#include <omnetpp.h>
+
+// Sample packet of a sensor node; the name carries the value, as before.
+// The sequence number and generation time let the OBN measure freshness;
+// the forwarding hub stamps how many samples of the sensor it has suppressed
+// so far, so that the OBN can tell suppressed samples from lost ones.
+class SensorSample : public omnetpp::cPacket {
+private:
+    int sourceId = -1;          // module id of the sensor node
+    long seq = 0;               // per-sensor sample number
+    omnetpp::simtime_t generationTime;
+    long suppressed = -1;       // samples of the sensor not forwarded by the hub so far, -1 if unknown
+
+public:
+    SensorSample(const char *name = nullptr) : omnetpp::cPacket(name) {}
+    SensorSample(const SensorSample& other)
+        : omnetpp::cPacket(other), sourceId(other.sourceId), seq(other.seq), generationTime(other.generationTime),
+          suppressed(other.suppressed) {}
+    virtual SensorSample *dup() const override { return new SensorSample(*this); }
+
+    int getSourceId() const { return sourceId; }
+    long getSeq() const { return seq; }
+    omnetpp::simtime_t getGenerationTime() const { return generationTime; }
+    void setSource(int id, long sequenceNumber, omnetpp::simtime_t time) { sourceId = id; seq = sequenceNumber; generationTime = time; }
+    long getSuppressed() const { return suppressed; }
+    void setSuppressed(long count) { suppressed = count; }
+};
+
+// One forwarded child sample inside an aggregate packet
+struct Sample {
+    int sourceId;   // module id of the sensor node that produced the sample
+    double value;   // raw sensor value as received by the hub
+    long seq;       // sample number at the sensor, -1 if unknown
+    omnetpp::simtime_t generationTime;
+    long suppressed; // samples of the sensor the hub has not forwarded so far, -1 if unknown
+};
+
+// Aggregate packet sent by a hub to the OBN: carries several forwarded
+// samples so that the uplink and the OBN see one event per batch.
+class SampleBatch : public omnetpp::cPacket {
+private:
+    std::vector<Sample> samples;
+
+public:
+    SampleBatch(const char *name = nullptr) : omnetpp::cPacket(name) {}
+    SampleBatch(const SampleBatch& other) : omnetpp::cPacket(other), samples(other.samples) {}
+    virtual SampleBatch *dup() const override { return new SampleBatch(*this); }
+
+    void addSample(int sourceId, double value, long seq = -1, omnetpp::simtime_t generationTime = 0, long suppressed = -1) {
+        samples.push_back(Sample{sourceId, value, seq, generationTime, suppressed});
+    }
+    int getNumSamples() const { return static_cast<int>(samples.size()); }
+    const Sample& getSample(int i) const { return samples[i]; }
+    const std::vector<Sample>& getSamples() const { return samples; }
+};
+
+#endif /* SAMPLEBATCH_H_ */
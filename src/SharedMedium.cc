@@ -0,0 +1,187 @@
+/*
+ * SharedMedium.cc
+ *
+ *  Created on: Aug 5, 2024
+ *      Author: pramita
+ */
+
+#include "SharedMedium.h"
+#include "CheckpointManager.h"
+
+#include <algorithm>
+
+using namespace omnetpp;
+
+Define_Module(SharedMedium);
+
+SharedMedium *SharedMedium::find()
+{
+    cModule *network = getSimulation()->getSystemModule();
+    SharedMedium *medium = network ? dynamic_cast<SharedMedium *>(network->getSubmodule("medium")) : nullptr;
+    return medium != nullptr && medium->par("interference").boolValue() ? medium : nullptr;
+}
+
+void SharedMedium::initialize()
+{
+    if (!par("interference").boolValue())
+        return;
+    configure();
+    CheckpointManager::restore(this);
+}
+
+void SharedMedium::configure()
+{
+    if (configured)
+        return;
+    configured = true;
+    mobility = MobilityManager::find();
+    if (mobility == nullptr)
+        throw cRuntimeError("The shared medium needs the node positions of a MobilityManager named 'mobility' in the network");
+    cellSize = par("interferenceRange").doubleValue();
+    pathLossExponent = par("pathLossExponent").doubleValue();
+    sinrThreshold = par("sinrThreshold").doubleValue();
+    if (cellSize <= 0)
+        throw cRuntimeError("interferenceRange must be positive");
+}
+
+void SharedMedium::handleMessage(cMessage *msg)
+{
+    throw cRuntimeError("SharedMedium does not receive messages");
+}
+
+long long SharedMedium::cellKey(int ix, int iy, int iz) const
+{
+    // 21 bits per coordinate
+    const long long offset = 1 << 20;
+    return ((ix + offset) << 42) | ((iy + offset) << 21) | (iz + offset);
+}
+
+double SharedMedium::receivedPower(double distance) const
+{
+    return std::pow(10, (mobility->getTxPower() - mobility->getPathLoss(distance, pathLossExponent)) / 10);
+}
+
+void SharedMedium::purge(Cell& cell, double now)
+{
+    while (!cell.empty()) {
+        auto it = transmissions.find(cell.front());
+        if (it != transmissions.end() && it->second.end >= now - retention)
+            break;
+        if (it != transmissions.end())
+            transmissions.erase(it);
+        cell.pop_front();
+    }
+}
+
+void SharedMedium::transmit(cModule *sender, cPacket *pkt, int gateIndex, double airtime)
+{
+    configure();
+    Transmission transmission;
+    if (!mobility->getPosition(sender, transmission.position))
+        return; // Not a body node, e.g. a test source
+    transmission.senderId = sender->getId();
+    transmission.start = SIMTIME_DBL(simTime());
+    transmission.end = transmission.start + airtime;
+
+    // A record is needed until the last packet it may overlap has arrived
+    cDatarateChannel *channel = dynamic_cast<cDatarateChannel *>(sender->gate("output_gate", gateIndex)->getChannel());
+    double delay = channel != nullptr ? SIMTIME_DBL(channel->getDelay()) : 0;
+    retention = std::max(retention, delay + airtime);
+
+    TransmissionKey key(pkt->getId(), transmission.senderId);
+    Cell& cell = cells[cellKey(cellIndex(transmission.position.x), cellIndex(transmission.position.y), cellIndex(transmission.position.z))];
+    purge(cell, transmission.start);
+    cell.push_back(key);
+    transmissions[key] = transmission;
+    numTransmissions++;
+}
+
+bool SharedMedium::receive(cPacket *pkt, cModule *receiver)
+{
+    auto wanted = transmissions.find(TransmissionKey(pkt->getId(), pkt->getSenderModuleId()));
+    MobilityManager::Vector3 position;
+    if (wanted == transmissions.end() || !mobility->getPosition(receiver, position))
+        return true; // Not sent through the medium
+    const Transmission& signal = wanted->second;
+    numReceptions++;
+
+    double now = SIMTIME_DBL(simTime());
+    double interference = 0;
+    bool receiverTransmitting = false;
+    int ix = cellIndex(position.x), iy = cellIndex(position.y), iz = cellIndex(position.z);
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dz = -1; dz <= 1; dz++) {
+                auto cell = cells.find(cellKey(ix + dx, iy + dy, iz + dz));
+                if (cell == cells.end())
+                    continue;
+                purge(cell->second, now);
+                for (const TransmissionKey& key : cell->second) {
+                    auto record = transmissions.find(key);
+                    if (record == transmissions.end())
+                        continue;
+                    const Transmission& other = record->second;
+                    if (other.start >= signal.end)
+                        break; // Later records start later still
+                    numInterferersChecked++;
+                    if (other.end <= signal.start || other.senderId == signal.senderId)
+                        continue;
+                    if (other.senderId == receiver->getId()) {
+                        receiverTransmitting = true;
+                        continue;
+                    }
+                    double ox = other.position.x - position.x, oy = other.position.y - position.y, oz = other.position.z - position.z;
+                    interference += receivedPower(std::sqrt(ox * ox + oy * oy + oz * oz));
+                }
+            }
+        }
+    }
+
+    double sx = signal.position.x - position.x, sy = signal.position.y - position.y, sz = signal.position.z - position.z;
+    double noise = std::pow(10, mobility->getNoiseFloor() / 10);
+    double sinr = 10 * std::log10(receivedPower(std::sqrt(sx * sx + sy * sy + sz * sz)) / (noise + interference));
+    sinrSum += sinr;
+    if (receiverTransmitting) {
+        numLostHalfDuplex++;
+    } else if (sinr < sinrThreshold) {
+        numLostToInterference++;
+    } else {
+        return true;
+    }
+    pkt->setBitError(true);
+    return false;
+}
+
+void SharedMedium::saveState(CheckpointWriter& writer)
+{
+    writer.putLong(numTransmissions);
+    writer.putLong(numReceptions);
+    writer.putLong(numLostToInterference);
+    writer.putLong(numLostHalfDuplex);
+    writer.putLong(numInterferersChecked);
+    writer.putDouble(sinrSum);
+}
+
+void SharedMedium::loadState(CheckpointReader& reader)
+{
+    numTransmissions = reader.getLong();
+    numReceptions = reader.getLong();
+    numLostToInterference = reader.getLong();
+    numLostHalfDuplex = reader.getLong();
+    numInterferersChecked = reader.getLong();
+    sinrSum = reader.getDouble();
+}
+
+void SharedMedium::finish()
+{
+    if (!configured)
+        return;
+    recordScalar("transmissions", numTransmissions);
+    recordScalar("receptions", numReceptions);
+    recordScalar("receptionsLostToInterference", numLostToInterference);
+    recordScalar("receptionsLostHalfDuplex", numLostHalfDuplex);
+    if (numReceptions > 0) {
+        recordScalar("sinr:mean", sinrSum / numReceptions, "dB");
+        recordScalar("interferersChecked:mean", static_cast<double>(numInterferersChecked) / numReceptions);
+    }
+}
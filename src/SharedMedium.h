@@ -0,0 +1,95 @@
+/*
+ * SharedMedium.h
+ *
+ *  Created on: Aug 5, 2024
+ *      Author: pramita
+ */
+
+#ifndef SHAREDMEDIUM_H_
+#define SHAREDMEDIUM_H_
+
+#include <cmath>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <omnetpp.h>
+#include "Checkpoint.h"
+#include "MobilityManager.h"
+
+// Interference between the point-to-point links: all transmissions share
+// one radio medium. The nodes report every transmission when it starts and
+// ask the medium when a packet arrives whether it was received. Reception
+// succeeds if the SINR at the receiver, over the packet's airtime, stays
+// above sinrThreshold and the receiver was not transmitting itself
+// (half duplex). Transmissions of the same node do not interfere with each
+// other, as without a transmit queue they stand for one burst of its radio.
+//
+// A transmission is identified by the message id together with the sender,
+// as a hub forwards a received packet object unchanged.
+//
+// Transmissions are indexed in a grid of cubic cells of interferenceRange
+// on the side, keyed by the sender's position; a reception only looks at
+// the 27 cells around the receiver, so the cost per packet depends on the
+// local density and not on the size of the network. Positions and the link
+// budget come from the MobilityManager. Records are dropped once no packet
+// they could overlap can still arrive.
+class SharedMedium : public omnetpp::cSimpleModule, public Checkpointable {
+protected:
+    struct Transmission {
+        int senderId;             // Module id
+        MobilityManager::Vector3 position;
+        double start, end;        // s
+    };
+    typedef std::pair<long, int> TransmissionKey; // Message id, sender module id
+    struct KeyHash {
+        size_t operator()(const TransmissionKey& key) const { return std::hash<long>()(key.first) * 31 + key.second; }
+    };
+    typedef std::deque<TransmissionKey> Cell; // In order of their start
+
+    bool configured = false;
+    MobilityManager *mobility = nullptr;
+    std::unordered_map<TransmissionKey, Transmission, KeyHash> transmissions;
+    std::unordered_map<long long, Cell> cells;
+    double cellSize;              // cm
+    double pathLossExponent;
+    double sinrThreshold;         // dB
+    double retention = 0;         // Longest propagation delay plus airtime seen, s
+
+    long numTransmissions = 0;
+    long numReceptions = 0;
+    long numLostToInterference = 0;
+    long numLostHalfDuplex = 0;
+    long numInterferersChecked = 0;
+    double sinrSum = 0;           // dB, over the receptions
+
+    virtual void initialize() override;
+    // Reads the parameters on first use, which may be before initialize()
+    // if a node transmits from its own
+    virtual void configure();
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+    virtual void finish() override;
+
+    long long cellKey(int ix, int iy, int iz) const;
+    int cellIndex(double coordinate) const { return static_cast<int>(std::floor(coordinate / cellSize)); }
+    // Received power in mW at the given distance in cm
+    double receivedPower(double distance) const;
+    // Drops the records of a cell that can no longer overlap an arriving packet
+    void purge(Cell& cell, double now);
+
+    // Checkpointable; taken when no packet is in flight, so only the counters matter
+    virtual void saveState(CheckpointWriter& writer) override;
+    virtual void loadState(CheckpointReader& reader) override;
+
+public:
+    // Returns the medium of the current network if interference is enabled,
+    // otherwise nullptr; may be called before the medium has initialized
+    static SharedMedium *find();
+
+    // Called by a node when it starts transmitting pkt on the given output gate
+    void transmit(omnetpp::cModule *sender, omnetpp::cPacket *pkt, int gateIndex, double airtime);
+    // Called by the receiving node when pkt arrives; returns false, and sets
+    // the packet's bit error flag, if it was lost to interference
+    bool receive(omnetpp::cPacket *pkt, omnetpp::cModule *receiver);
+};
+
+#endif /* SHAREDMEDIUM_H_ */
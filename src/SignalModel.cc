@@ -0,0 +1,199 @@
+/*
+ * SignalModel.cc
+ *
+ *  Created on: Jul 15, 2024
+ *      Author: pramita
+ */
+
+#include "SignalModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "Checkpoint.h"
+
+SignalModel *SignalModel::create(const std::string& name, omnetpp::cRNG *rng, const SignalParams& params)
+{
+    if (name == "uniform")
+        return new UniformSignal(rng, params);
+    if (name == "randomWalk")
+        return new RandomWalkSignal(rng, params);
+    if (name == "sinusoid")
+        return new SinusoidSignal(rng, params);
+    if (name == "ar")
+        return new ArSignal(rng, params);
+    if (name == "piecewiseConstant")
+        return new PiecewiseConstantSignal(rng, params);
+    if (name == "bursts")
+        return new BurstSignal(rng, params);
+    throw std::invalid_argument("Unknown signal model '" + name + "'");
+}
+
+double SignalModel::normal()
+{
+    if (_has_spare_normal) {
+        _has_spare_normal = false;
+        return _spare_normal;
+    }
+    double r = std::sqrt(-2 * std::log(_rng->doubleRandNonz()));
+    double phi = 2 * M_PI * _rng->doubleRand();
+    _spare_normal = r * std::sin(phi);
+    _has_spare_normal = true;
+    return r * std::cos(phi);
+}
+
+void SignalModel::saveState(CheckpointWriter& writer) const
+{
+    writer.putBool(_has_spare_normal);
+    writer.putDouble(_spare_normal);
+}
+
+void SignalModel::loadState(CheckpointReader& reader)
+{
+    _has_spare_normal = reader.getBool();
+    _spare_normal = reader.getDouble();
+}
+
+void UniformSignal::generate(double *values, int count)
+{
+    int lower = static_cast<int>(_params.lower), upper = static_cast<int>(_params.upper);
+    for (int i = 0; i < count; i++)
+        values[i] = omnetpp::intuniform(_rng, lower, upper);
+}
+
+void RandomWalkSignal::generate(double *values, int count)
+{
+    for (int i = 0; i < count; i++) {
+        _level += _params.walkStep * normal();
+        if (_level < _params.lower)
+            _level = std::min(2 * _params.lower - _level, _params.upper);
+        else if (_level > _params.upper)
+            _level = std::max(2 * _params.upper - _level, _params.lower);
+        values[i] = _level + noise();
+    }
+}
+
+void RandomWalkSignal::saveState(CheckpointWriter& writer) const
+{
+    SignalModel::saveState(writer);
+    writer.putDouble(_level);
+}
+
+void RandomWalkSignal::loadState(CheckpointReader& reader)
+{
+    SignalModel::loadState(reader);
+    _level = reader.getDouble();
+}
+
+SinusoidSignal::SinusoidSignal(omnetpp::cRNG *rng, const SignalParams& params) : SignalModel(rng, params)
+{
+    if (params.period <= 0)
+        throw std::invalid_argument("Signal period must be positive");
+    _step_sin = std::sin(2 * M_PI / params.period);
+    _step_cos = std::cos(2 * M_PI / params.period);
+}
+
+void SinusoidSignal::generate(double *values, int count)
+{
+    // Exact phase at the start of the block, so that rounding errors of the rotation do not accumulate
+    double phase = 2 * M_PI * std::fmod(static_cast<double>(_n), _params.period) / _params.period;
+    double s = std::sin(phase), c = std::cos(phase);
+    for (int i = 0; i < count; i++) {
+        values[i] = _params.mean + _params.amplitude * s + noise();
+        double next = s * _step_cos + c * _step_sin;
+        c = c * _step_cos - s * _step_sin;
+        s = next;
+    }
+    _n += count;
+}
+
+void SinusoidSignal::saveState(CheckpointWriter& writer) const
+{
+    SignalModel::saveState(writer);
+    writer.putLong(_n);
+}
+
+void SinusoidSignal::loadState(CheckpointReader& reader)
+{
+    SignalModel::loadState(reader);
+    _n = reader.getLong();
+}
+
+void ArSignal::generate(double *values, int count)
+{
+    const std::vector<double>& phi = _params.arCoefficients;
+    size_t p = phi.size();
+    for (int i = 0; i < count; i++) {
+        // _history[_pos] is x_{n-p}, the value before it x_{n-1}
+        double deviation = noise();
+        for (size_t k = 0; k < p; k++)
+            deviation += phi[k] * _history[(_pos + p - 1 - k) % p];
+        if (p > 0) {
+            _history[_pos] = deviation;
+            _pos = (_pos + 1) % p;
+        }
+        values[i] = _params.mean + deviation;
+    }
+}
+
+void ArSignal::saveState(CheckpointWriter& writer) const
+{
+    SignalModel::saveState(writer);
+    writer.putDoubles(_history);
+    writer.putInt(static_cast<int>(_pos));
+}
+
+void ArSignal::loadState(CheckpointReader& reader)
+{
+    SignalModel::loadState(reader);
+    _history = reader.getDoubles();
+    _pos = reader.getInt();
+    if (_history.size() != _params.arCoefficients.size())
+        throw std::runtime_error("Checkpoint has a different AR model order");
+}
+
+void PiecewiseConstantSignal::generate(double *values, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (uniform() < _params.jumpProbability)
+            _level = _params.lower + uniform() * (_params.upper - _params.lower);
+        values[i] = _level + noise();
+    }
+}
+
+void PiecewiseConstantSignal::saveState(CheckpointWriter& writer) const
+{
+    SignalModel::saveState(writer);
+    writer.putDouble(_level);
+}
+
+void PiecewiseConstantSignal::loadState(CheckpointReader& reader)
+{
+    SignalModel::loadState(reader);
+    _level = reader.getDouble();
+}
+
+void BurstSignal::generate(double *values, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (_burst_remaining == 0 && uniform() < _params.burstProbability)
+            _burst_remaining = _params.burstLength;
+        values[i] = _params.mean + noise();
+        if (_burst_remaining > 0) {
+            values[i] += _params.burstAmplitude;
+            _burst_remaining--;
+        }
+    }
+}
+
+void BurstSignal::saveState(CheckpointWriter& writer) const
+{
+    SignalModel::saveState(writer);
+    writer.putInt(_burst_remaining);
+}
+
+void BurstSignal::loadState(CheckpointReader& reader)
+{
+    SignalModel::loadState(reader);
+    _burst_remaining = reader.getInt();
+}
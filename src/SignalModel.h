@@ -0,0 +1,140 @@
+/*
+ * SignalModel.h
+ *
+ *  Created on: Jul 15, 2024
+ *      Author: pramita
+ */
+
+#ifndef SIGNALMODEL_H_
+#define SIGNALMODEL_H_
+
+#include <string>
+#include <vector>
+#include <omnetpp.h>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// Settings of a sensor's signal model; which fields are used depends on the model
+struct SignalParams {
+    double lower = 0;           // Range of the sensor
+    double upper = 0;
+    double mean = 0;            // Level the signal varies around
+    double noise = 0;           // Standard deviation of the measurement noise
+    double walkStep = 0;        // randomWalk: standard deviation of a step
+    double amplitude = 0;       // sinusoid
+    double period = 0;          // sinusoid: samples per period
+    std::vector<double> arCoefficients; // ar: phi_1 ... phi_p
+    double jumpProbability = 0; // piecewiseConstant: per sample
+    double burstProbability = 0; // bursts: per sample
+    int burstLength = 0;        // bursts: samples
+    double burstAmplitude = 0;  // bursts: added to the signal during a burst
+};
+
+// Stateful generator of sensor values. generate() fills a whole block, so
+// that the per-sample cost is a few arithmetic operations and draws of the
+// node's RNG. Values are not limited to the sensor's range; the caller
+// saturates them like an ADC would.
+class SignalModel {
+protected:
+    omnetpp::cRNG *_rng;
+    SignalParams _params;
+    bool _has_spare_normal = false;
+    double _spare_normal = 0;
+
+    // Standard normal variates, Box-Muller in pairs
+    double normal();
+    double uniform() { return _rng->doubleRand(); }
+    double noise() { return _params.noise > 0 ? _params.noise * normal() : 0; }
+
+public:
+    SignalModel(omnetpp::cRNG *rng, const SignalParams& params) : _rng(rng), _params(params) {}
+    virtual ~SignalModel() {}
+
+    // One of uniform, randomWalk, sinusoid, ar, piecewiseConstant, bursts;
+    // throws std::invalid_argument for an unknown name
+    static SignalModel *create(const std::string& name, omnetpp::cRNG *rng, const SignalParams& params);
+
+    virtual void generate(double *values, int count) = 0;
+
+    virtual void saveState(CheckpointWriter& writer) const;
+    virtual void loadState(CheckpointReader& reader);
+};
+
+// Independent integers drawn uniformly from the sensor's range, one draw each
+// (the original behaviour of the sensors)
+class UniformSignal : public SignalModel {
+public:
+    using SignalModel::SignalModel;
+    virtual void generate(double *values, int count) override;
+};
+
+// Random walk reflected at the range limits, plus measurement noise
+class RandomWalkSignal : public SignalModel {
+private:
+    double _level;
+
+public:
+    RandomWalkSignal(omnetpp::cRNG *rng, const SignalParams& params) : SignalModel(rng, params), _level(params.mean) {}
+    virtual void generate(double *values, int count) override;
+    virtual void saveState(CheckpointWriter& writer) const override;
+    virtual void loadState(CheckpointReader& reader) override;
+};
+
+// mean + amplitude * sin(2 pi n / period), plus measurement noise. Within a
+// block the sine is advanced by a rotation instead of calling sin() per sample.
+class SinusoidSignal : public SignalModel {
+private:
+    long _n = 0;
+    double _step_sin;
+    double _step_cos;
+
+public:
+    SinusoidSignal(omnetpp::cRNG *rng, const SignalParams& params);
+    virtual void generate(double *values, int count) override;
+    virtual void saveState(CheckpointWriter& writer) const override;
+    virtual void loadState(CheckpointReader& reader) override;
+};
+
+// Autoregressive process of order p around the mean:
+// x_n - mean = sum phi_i (x_{n-i} - mean) + e_n, e_n ~ N(0, noise^2)
+class ArSignal : public SignalModel {
+private:
+    std::vector<double> _history; // Deviations from the mean, ring buffer of p values
+    size_t _pos = 0;              // Oldest value of _history
+
+public:
+    ArSignal(omnetpp::cRNG *rng, const SignalParams& params)
+        : SignalModel(rng, params), _history(params.arCoefficients.size(), 0.0) {}
+    virtual void generate(double *values, int count) override;
+    virtual void saveState(CheckpointWriter& writer) const override;
+    virtual void loadState(CheckpointReader& reader) override;
+};
+
+// Constant level that jumps to a uniformly drawn new level with
+// jumpProbability per sample, plus measurement noise
+class PiecewiseConstantSignal : public SignalModel {
+private:
+    double _level;
+
+public:
+    PiecewiseConstantSignal(omnetpp::cRNG *rng, const SignalParams& params) : SignalModel(rng, params), _level(params.mean) {}
+    virtual void generate(double *values, int count) override;
+    virtual void saveState(CheckpointWriter& writer) const override;
+    virtual void loadState(CheckpointReader& reader) override;
+};
+
+// Noisy baseline with bursts: with burstProbability per sample a burst of
+// burstLength samples starts, during which burstAmplitude is added
+class BurstSignal : public SignalModel {
+private:
+    int _burst_remaining = 0;
+
+public:
+    using SignalModel::SignalModel;
+    virtual void generate(double *values, int count) override;
+    virtual void saveState(CheckpointWriter& writer) const override;
+    virtual void loadState(CheckpointReader& reader) override;
+};
+
+#endif /* SIGNALMODEL_H_ */
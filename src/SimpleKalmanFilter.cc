@@ -9,10 +9,15 @@
 
 #include <cmath>
 
+#include "Checkpoint.h"
+
 SimpleKalmanFilter::SimpleKalmanFilter(float mea_e, float est_e, float q) {
     _err_measure = mea_e;
     _err_estimate = est_e;
     _q = q;
+    _last_estimate = 0;
+    _current_estimate = 0;
+    _kalman_gain = 0;
 }
 
 float SimpleKalmanFilter::updateEstimate(float mea) {
@@ -44,5 +49,20 @@ float SimpleKalmanFilter::getEstimateError() {
     return _err_estimate;
 }
 
+void SimpleKalmanFilter::saveState(CheckpointWriter& writer) const {
+    writer.putFloat(_err_measure);
+    writer.putFloat(_err_estimate);
+    writer.putFloat(_q);
+    writer.putFloat(_last_estimate);
+    writer.putFloat(_current_estimate);
+    writer.putFloat(_kalman_gain);
+}
 
-
+void SimpleKalmanFilter::loadState(CheckpointReader& reader) {
+    _err_measure = reader.getFloat();
+    _err_estimate = reader.getFloat();
+    _q = reader.getFloat();
+    _last_estimate = reader.getFloat();
+    _current_estimate = reader.getFloat();
+    _kalman_gain = reader.getFloat();
+}
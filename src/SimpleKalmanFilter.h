@@ -8,6 +8,9 @@
 #ifndef SIMPLEKALMANFILTER_H_
 #define SIMPLEKALMANFILTER_H_
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class SimpleKalmanFilter {
 private:
     float _err_measure;
@@ -25,6 +28,8 @@ public:
     void setProcessNoise(float q);
     float getKalmanGain();
     float getEstimateError();
+    void saveState(CheckpointWriter& writer) const;
+    void loadState(CheckpointReader& reader);
 };
 
 #endif /* SIMPLEKALMANFILTER_H_ */
@@ -0,0 +1,121 @@
+/*
+ * SteadyStateDetector.cc
+ *
+ *  Created on: May 13, 2024
+ *      Author: pramita
+ */
+
+#include "SteadyStateDetector.h"
+
+#include <cmath>
+
+#include "Checkpoint.h"
+
+// Two-sided 95% quantile of Student's t distribution with NUM_CI_BATCHES - 1 degrees of freedom
+static const double T_QUANTILE_19 = 2.093;
+
+void SteadyStateDetector::collect(double value) {
+    _batch_sum += value;
+    if (++_batch_count == _batch_size) {
+        _batch_means.push_back(_batch_sum / _batch_size);
+        _batch_sum = 0;
+        _batch_count = 0;
+        if (static_cast<int>(_batch_means.size()) >= _max_batches)
+            mergeBatches();
+    }
+}
+
+void SteadyStateDetector::mergeBatches() {
+    // Pairs of neighbouring batches become one batch of twice the size; an
+    // odd batch at the end is kept as the partial batch being filled
+    size_t pairs = _batch_means.size() / 2;
+    for (size_t i = 0; i < pairs; i++)
+        _batch_means[i] = (_batch_means[2 * i] + _batch_means[2 * i + 1]) / 2;
+    if (_batch_means.size() % 2 != 0) {
+        _batch_sum += _batch_means.back() * _batch_size;
+        _batch_count += _batch_size;
+    }
+    _batch_means.resize(pairs);
+    _batch_size *= 2;
+}
+
+long SteadyStateDetector::getTruncationBatch() const {
+    // MSER statistic for truncation point d over batch means y[d..n-1]:
+    // sum of squared deviations divided by (n - d)^2; d is searched in the
+    // first half of the series as recommended for MSER
+    long n = static_cast<long>(_batch_means.size());
+    if (n < 2)
+        return 0;
+    std::vector<double>& suffixSum = _suffix_sum;
+    std::vector<double>& suffixSq = _suffix_sq;
+    suffixSum.assign(n + 1, 0.0);
+    suffixSq.assign(n + 1, 0.0);
+    for (long i = n - 1; i >= 0; i--) {
+        suffixSum[i] = suffixSum[i + 1] + _batch_means[i];
+        suffixSq[i] = suffixSq[i + 1] + _batch_means[i] * _batch_means[i];
+    }
+    long best = 0;
+    double bestStat = INFINITY;
+    for (long d = 0; d <= n / 2; d++) {
+        double m = n - d;
+        double ss = suffixSq[d] - suffixSum[d] * suffixSum[d] / m;
+        double stat = ss / (m * m);
+        if (stat < bestStat) {
+            bestStat = stat;
+            best = d;
+        }
+    }
+    return best;
+}
+
+double SteadyStateDetector::getSteadyStateMean(long truncationBatch) const {
+    long n = static_cast<long>(_batch_means.size());
+    long d = truncationBatch;
+    if (n - d <= 0)
+        return NAN;
+    double sum = 0;
+    for (long i = d; i < n; i++)
+        sum += _batch_means[i];
+    return sum / (n - d);
+}
+
+double SteadyStateDetector::getConfidenceHalfWidth(long truncationBatch) const {
+    long n = static_cast<long>(_batch_means.size());
+    long d = truncationBatch;
+    long perBatch = (n - d) / NUM_CI_BATCHES;
+    if (perBatch < 1)
+        return -1;
+
+    // Group the retained batch means into NUM_CI_BATCHES larger batches,
+    // dropping the remainder at the start of the retained series
+    long start = n - perBatch * NUM_CI_BATCHES;
+    double means[NUM_CI_BATCHES];
+    double total = 0;
+    for (int k = 0; k < NUM_CI_BATCHES; k++) {
+        double sum = 0;
+        for (long i = 0; i < perBatch; i++)
+            sum += _batch_means[start + k * perBatch + i];
+        means[k] = sum / perBatch;
+        total += means[k];
+    }
+    double mean = total / NUM_CI_BATCHES;
+    double var = 0;
+    for (int k = 0; k < NUM_CI_BATCHES; k++)
+        var += (means[k] - mean) * (means[k] - mean);
+    var /= NUM_CI_BATCHES - 1;
+    return T_QUANTILE_19 * std::sqrt(var / NUM_CI_BATCHES);
+}
+
+void SteadyStateDetector::saveState(CheckpointWriter& writer) const {
+    writer.putInt(_batch_size);
+    writer.putDoubles(_batch_means);
+    writer.putDouble(_batch_sum);
+    writer.putInt(_batch_count);
+}
+
+void SteadyStateDetector::loadState(CheckpointReader& reader) {
+    _batch_size = reader.getInt();
+    _batch_means = reader.getDoubles();
+    _batch_sum = reader.getDouble();
+    _batch_count = reader.getInt();
+}
@@ -0,0 +1,64 @@
+/*
+ * SteadyStateDetector.h
+ *
+ *  Created on: May 13, 2024
+ *      Author: pramita
+ */
+
+#ifndef STEADYSTATEDETECTOR_H_
+#define STEADYSTATEDETECTOR_H_
+
+#include <cstddef>
+#include <vector>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// MSER-m truncation (m = batch size, 5 by default) of an output series and a
+// batch-means confidence interval for the mean of the truncated series. Only
+// the batch means are stored, so memory is 1/m of the series length. Once
+// maxBatches batch means are stored, neighbouring batches are merged and m
+// doubles, so memory and the cost of one MSER search stay bounded however
+// long the run is.
+class SteadyStateDetector {
+private:
+    int _batch_size;
+    int _max_batches;
+    std::vector<double> _batch_means;
+    double _batch_sum = 0;
+    int _batch_count = 0;
+    mutable std::vector<double> _suffix_sum; // Scratch space of getTruncationBatch()
+    mutable std::vector<double> _suffix_sq;
+
+    void mergeBatches();
+
+public:
+    static const int NUM_CI_BATCHES = 20;
+
+    SteadyStateDetector(int batchSize = 5, int maxBatches = 2048) : _batch_size(batchSize), _max_batches(maxBatches) {}
+    void collect(double value);
+
+    // Number of values collected in complete batches
+    long getCount() const { return static_cast<long>(_batch_means.size()) * _batch_size; }
+    // Number of leading batches that MSER identifies as initial transient;
+    // O(number of batches), so callers that need several of the results below
+    // compute it once and pass it on
+    long getTruncationBatch() const;
+    // Number of leading values that MSER identifies as initial transient
+    long getTruncationPoint() const { return getTruncationBatch() * _batch_size; }
+    long getTruncationPoint(long truncationBatch) const { return truncationBatch * _batch_size; }
+    double getSteadyStateMean() const { return getSteadyStateMean(getTruncationBatch()); }
+    double getSteadyStateMean(long truncationBatch) const;
+    // Half width of the 95% confidence interval of the steady-state mean,
+    // computed from NUM_CI_BATCHES batch means; negative if there are too few values
+    double getConfidenceHalfWidth() const { return getConfidenceHalfWidth(getTruncationBatch()); }
+    double getConfidenceHalfWidth(long truncationBatch) const;
+
+    // Heap memory of the stored batch means
+    size_t getHeapBytes() const { return (_batch_means.capacity() + _suffix_sum.capacity() + _suffix_sq.capacity()) * sizeof(double); }
+
+    void saveState(CheckpointWriter& writer) const;
+    void loadState(CheckpointReader& reader);
+};
+
+#endif /* STEADYSTATEDETECTOR_H_ */
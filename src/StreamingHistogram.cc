@@ -0,0 +1,89 @@
+/*
+ * StreamingHistogram.cc
+ *
+ *  Created on: Jul 1, 2024
+ *      Author: pramita
+ */
+
+#include "StreamingHistogram.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "Checkpoint.h"
+
+StreamingHistogram::StreamingHistogram(double lower, double upper, int binsPerDecade)
+    : _lower(lower), _bins_per_decade(binsPerDecade)
+{
+    int numBins = static_cast<int>(std::ceil(std::log10(upper / lower) * binsPerDecade));
+    _bins.assign(numBins + 2, 0);
+}
+
+void StreamingHistogram::collect(double value)
+{
+    if (_count == 0 || value < _min)
+        _min = value;
+    if (_count == 0 || value > _max)
+        _max = value;
+    _count++;
+    _sum += value;
+
+    int last = static_cast<int>(_bins.size()) - 1;
+    int bin = 0;
+    if (value >= _lower) {
+        bin = 1 + static_cast<int>(std::log10(value / _lower) * _bins_per_decade);
+        if (bin > last)
+            bin = last;
+    }
+    _bins[bin]++;
+}
+
+double StreamingHistogram::getBinLowerEdge(int bin) const
+{
+    return _lower * std::pow(10.0, (bin - 1) / _bins_per_decade);
+}
+
+double StreamingHistogram::getQuantile(double q) const
+{
+    if (_count == 0)
+        return 0;
+    double rank = q * _count;
+    long cumulative = 0;
+    int last = static_cast<int>(_bins.size()) - 1;
+    for (int bin = 0; bin <= last; bin++) {
+        if (_bins[bin] == 0 || cumulative + _bins[bin] < rank) {
+            cumulative += _bins[bin];
+            continue;
+        }
+        // Interpolate inside the bin, clamped to the observed range
+        double low = bin == 0 ? _min : getBinLowerEdge(bin);
+        double high = bin == last ? _max : getBinLowerEdge(bin + 1);
+        double value = low + (high - low) * (rank - cumulative) / _bins[bin];
+        return std::fmin(std::fmax(value, _min), _max);
+    }
+    return _max;
+}
+
+void StreamingHistogram::saveState(CheckpointWriter& writer) const
+{
+    writer.putLong(_count);
+    writer.putDouble(_sum);
+    writer.putDouble(_min);
+    writer.putDouble(_max);
+    writer.putInt(static_cast<int>(_bins.size()));
+    for (long n : _bins)
+        writer.putLong(n);
+}
+
+void StreamingHistogram::loadState(CheckpointReader& reader)
+{
+    _count = reader.getLong();
+    _sum = reader.getDouble();
+    _min = reader.getDouble();
+    _max = reader.getDouble();
+    int numBins = reader.getInt();
+    if (numBins != static_cast<int>(_bins.size()))
+        throw std::runtime_error("Checkpoint histogram has a different number of bins");
+    for (long& n : _bins)
+        n = reader.getLong();
+}
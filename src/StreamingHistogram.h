@@ -0,0 +1,49 @@
+/*
+ * StreamingHistogram.h
+ *
+ *  Created on: Jul 1, 2024
+ *      Author: pramita
+ */
+
+#ifndef STREAMINGHISTOGRAM_H_
+#define STREAMINGHISTOGRAM_H_
+
+#include <cstddef>
+#include <vector>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// Fixed-size histogram of positive values with logarithmic bins (by default
+// 10 per decade from 1us to 1000s), plus exact count, mean, min and max.
+// collect() is O(1) and memory does not grow with the number of values;
+// quantiles are interpolated within a bin, i.e. accurate to about 12%.
+class StreamingHistogram {
+private:
+    double _lower;
+    double _bins_per_decade;
+    std::vector<long> _bins;   // [0] underflow, [n-1] overflow
+    long _count = 0;
+    double _sum = 0;
+    double _min = 0;
+    double _max = 0;
+
+    double getBinLowerEdge(int bin) const;
+
+public:
+    StreamingHistogram(double lower = 1e-6, double upper = 1e3, int binsPerDecade = 10);
+    void collect(double value);
+
+    long getCount() const { return _count; }
+    double getMean() const { return _count ? _sum / _count : 0; }
+    double getMin() const { return _min; }
+    double getMax() const { return _max; }
+    double getQuantile(double q) const;
+    // Heap memory of the bins
+    size_t getHeapBytes() const { return _bins.capacity() * sizeof(long); }
+
+    void saveState(CheckpointWriter& writer) const;
+    void loadState(CheckpointReader& reader);
+};
+
+#endif /* STREAMINGHISTOGRAM_H_ */
@@ -0,0 +1,144 @@
+/*
+ * TxQueue.cc
+ *
+ *  Created on: Jun 17, 2024
+ *      Author: pramita
+ */
+
+#include "TxQueue.h"
+#include "Checkpoint.h"
+
+using namespace omnetpp;
+
+TxQueue::TxQueue()
+{
+    for (int p = 0; p < NUM_PRIORITIES; p++) {
+        _enqueued[p] = _dropped[p] = _served[p] = 0;
+        _delay_sum[p] = _max_delay[p] = 0;
+    }
+}
+
+TxQueue::~TxQueue()
+{
+    for (Link& link : _links)
+        for (int p = 0; p < NUM_PRIORITIES; p++)
+            for (Entry& entry : link.fifo[p])
+                delete entry.pkt;
+}
+
+void TxQueue::configure(int numLinks, int capacity)
+{
+    _links.resize(numLinks);
+    _capacity = capacity;
+}
+
+void TxQueue::changeLength(int delta, double now)
+{
+    now += _time_base;
+    _length_integral += _length * (now - _last_change);
+    _last_change = now;
+    _length += delta;
+    if (_length > _max_length)
+        _max_length = _length;
+}
+
+cPacket *TxQueue::enqueue(cPacket *pkt, int linkIndex, Priority priority, double now)
+{
+    Link& link = _links.at(linkIndex);
+    _enqueued[priority]++;
+    if (_capacity > 0 && link.length >= _capacity) {
+        // Full: displace the newest packet of lower priority, if there is one
+        for (int p = NUM_PRIORITIES - 1; p > priority; p--) {
+            if (!link.fifo[p].empty()) {
+                cPacket *displaced = link.fifo[p].back().pkt;
+                link.fifo[p].pop_back();
+                link.fifo[priority].push_back(Entry{pkt, now});
+                _dropped[p]++;
+                return displaced;
+            }
+        }
+        _dropped[priority]++;
+        return pkt;
+    }
+    link.fifo[priority].push_back(Entry{pkt, now});
+    link.length++;
+    changeLength(1, now);
+    return nullptr;
+}
+
+cPacket *TxQueue::dequeue(int& linkIndex, double now)
+{
+    if (_length == 0)
+        return nullptr;
+    int numLinks = static_cast<int>(_links.size());
+    for (int p = 0; p < NUM_PRIORITIES; p++) {
+        for (int i = 0; i < numLinks; i++) {
+            int l = (_next_link + i) % numLinks;
+            Link& link = _links[l];
+            if (link.fifo[p].empty())
+                continue;
+            Entry entry = link.fifo[p].front();
+            link.fifo[p].pop_front();
+            link.length--;
+            changeLength(-1, now);
+
+            double delay = now - entry.enqueueTime;
+            _served[p]++;
+            _delay_sum[p] += delay;
+            if (delay > _max_delay[p])
+                _max_delay[p] = delay;
+
+            _next_link = (l + 1) % numLinks;
+            linkIndex = l;
+            return entry.pkt;
+        }
+    }
+    return nullptr;
+}
+
+double TxQueue::getMeanLength(double now) const
+{
+    now += _time_base;
+    double integral = _length_integral + _length * (now - _last_change);
+    return now > 0 ? integral / now : 0;
+}
+
+const char *TxQueue::getPriorityName(Priority priority)
+{
+    switch (priority) {
+        case CONTROL: return "control";
+        case DATA: return "data";
+        default: return "?";
+    }
+}
+
+void TxQueue::saveState(CheckpointWriter& writer, double now) const
+{
+    writer.putDouble(now + _time_base);
+    writer.putInt(_next_link);
+    writer.putInt(_max_length);
+    writer.putDouble(_length_integral);
+    for (int p = 0; p < NUM_PRIORITIES; p++) {
+        writer.putLong(_enqueued[p]);
+        writer.putLong(_dropped[p]);
+        writer.putLong(_served[p]);
+        writer.putDouble(_delay_sum[p]);
+        writer.putDouble(_max_delay[p]);
+    }
+}
+
+void TxQueue::loadState(CheckpointReader& reader, double now)
+{
+    _last_change = reader.getDouble();
+    _time_base = _last_change - now;
+    _next_link = reader.getInt();
+    _max_length = reader.getInt();
+    _length_integral = reader.getDouble();
+    for (int p = 0; p < NUM_PRIORITIES; p++) {
+        _enqueued[p] = reader.getLong();
+        _dropped[p] = reader.getLong();
+        _served[p] = reader.getLong();
+        _delay_sum[p] = reader.getDouble();
+        _max_delay[p] = reader.getDouble();
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * TxQueue.h
+ *
+ *  Created on: Jun 17, 2024
+ *      Author: pramita
+ */
+
+#ifndef TXQUEUE_H_
+#define TXQUEUE_H_
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <omnetpp.h>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// Transmit queues of a node with a single radio. Every output link has a
+// bounded queue with one FIFO per priority; the radio serves the highest
+// priority first and the links of equal priority round robin. When a link's
+// queue is full, a control packet displaces the newest data packet of that
+// link and any other packet is dropped. The queue holds the packets only;
+// the owning module sends them and times the transmissions.
+class TxQueue {
+public:
+    enum Priority { CONTROL, DATA, NUM_PRIORITIES };
+
+private:
+    struct Entry {
+        omnetpp::cPacket *pkt;
+        double enqueueTime;
+    };
+    struct Link {
+        std::deque<Entry> fifo[NUM_PRIORITIES];
+        int length = 0;
+    };
+
+    std::vector<Link> _links;
+    int _capacity = 0;           // Packets per link, 0 = unlimited
+    int _next_link = 0;          // Round robin position
+    bool _busy = false;          // A transmission is in progress
+
+    // Statistics
+    int _length = 0;             // Packets queued over all links
+    int _max_length = 0;
+    double _length_integral = 0; // Packet-seconds, for the time average
+    double _last_change = 0;
+    double _time_base = 0;       // Added to simulation time after a restore from a checkpoint
+    long _enqueued[NUM_PRIORITIES];
+    long _dropped[NUM_PRIORITIES];
+    long _served[NUM_PRIORITIES];
+    double _delay_sum[NUM_PRIORITIES];
+    double _max_delay[NUM_PRIORITIES];
+
+    void changeLength(int delta, double now);
+
+public:
+    TxQueue();
+    ~TxQueue();
+    void configure(int numLinks, int capacity);
+
+    // Queues the packet; returns a packet that had to be dropped (the new
+    // one or a displaced one, to be deleted by the caller) or nullptr
+    omnetpp::cPacket *enqueue(omnetpp::cPacket *pkt, int link, Priority priority, double now);
+    // Next packet to transmit, or nullptr if all queues are empty
+    omnetpp::cPacket *dequeue(int& link, double now);
+
+    bool isEmpty() const { return _length == 0; }
+    bool isBusy() const { return _busy; }
+    void setBusy(bool busy) { _busy = busy; }
+    int getLength() const { return _length; }
+    double getMeanLength(double now) const;
+
+    static const char *getPriorityName(Priority priority);
+
+    // Statistics only: queues are empty whenever a checkpoint is taken.
+    // Times are kept on the axis of the original run, as in EnergyModel.
+    void saveState(CheckpointWriter& writer, double now) const;
+    void loadState(CheckpointReader& reader, double now);
+
+    // Records the queue results as scalars of the given module at finish()
+    template <class Module>
+    void recordScalars(Module *module, double now) {
+        module->recordScalar("txQueueLength:mean", getMeanLength(now));
+        module->recordScalar("txQueueLength:max", _max_length);
+        for (int p = 0; p < NUM_PRIORITIES; p++) {
+            std::string suffix = std::string(":") + getPriorityName(static_cast<Priority>(p));
+            module->recordScalar(("txPackets" + suffix).c_str(), _enqueued[p]);
+            module->recordScalar(("txDrops" + suffix).c_str(), _dropped[p]);
+            module->recordScalar(("txQueueingDelay:mean" + suffix).c_str(), _served[p] ? _delay_sum[p] / _served[p] : 0, "s");
+            module->recordScalar(("txQueueingDelay:max" + suffix).c_str(), _max_delay[p], "s");
+        }
+    }
+};
+
+#endif /* TXQUEUE_H_ */
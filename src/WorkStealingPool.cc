@@ -0,0 +1,97 @@
+/*
+ * WorkStealingPool.cc
+ *
+ *  Created on: Jun 3, 2024
+ *      Author: pramita
+ */
+
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(int numThreads) {
+    if (numThreads <= 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 0; i < numThreads; i++)
+        _queues.emplace_back(new Queue());
+    // The calling thread works on the last queue
+    for (int i = 0; i < numThreads - 1; i++)
+        _workers.emplace_back(&WorkStealingPool::workerLoop, this, static_cast<size_t>(i));
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _work_available.notify_all();
+    for (std::thread& worker : _workers)
+        worker.join();
+}
+
+bool WorkStealingPool::popOrSteal(size_t self, Task& task) {
+    {
+        Queue& own = *_queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < _queues.size(); i++) {
+        Queue& victim = *_queues[(self + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t self) {
+    long seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _work_available.wait(lock, [&] { return _stopping || _generation != seenGeneration; });
+            if (_stopping)
+                return;
+            seenGeneration = _generation;
+        }
+        Task task;
+        while (popOrSteal(self, task)) {
+            task();
+            if (--_pending == 0) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _batch_done.notify_all();
+            }
+        }
+    }
+}
+
+void WorkStealingPool::run(std::vector<Task>& tasks) {
+    if (tasks.empty())
+        return;
+    _pending = static_cast<long>(tasks.size());
+    for (size_t i = 0; i < tasks.size(); i++) {
+        Queue& queue = *_queues[i % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(tasks[i]));
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _generation++;
+    }
+    _work_available.notify_all();
+
+    Task task;
+    size_t self = _queues.size() - 1;
+    while (popOrSteal(self, task)) {
+        task();
+        --_pending;
+    }
+    std::unique_lock<std::mutex> lock(_mutex);
+    _batch_done.wait(lock, [&] { return _pending == 0; });
+    tasks.clear();
+}
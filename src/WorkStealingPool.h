@@ -0,0 +1,57 @@
+/*
+ * WorkStealingPool.h
+ *
+ *  Created on: Jun 3, 2024
+ *      Author: pramita
+ */
+
+#ifndef WORKSTEALINGPOOL_H_
+#define WORKSTEALINGPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool for fork-join batches. Tasks are distributed over
+// per-worker deques; a worker takes tasks from the back of its own deque and
+// steals from the front of the others when it runs dry. The calling thread
+// takes part in the work until the whole batch is done.
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> _queues; // One per worker plus one for the calling thread
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _work_available;
+    std::condition_variable _batch_done;
+    std::atomic<long> _pending{0};
+    long _generation = 0;
+    bool _stopping = false;
+
+    bool popOrSteal(size_t self, Task& task);
+    void workerLoop(size_t self);
+
+public:
+    // numThreads <= 0 uses one thread per hardware core
+    explicit WorkStealingPool(int numThreads);
+    ~WorkStealingPool();
+
+    int getNumThreads() const { return static_cast<int>(_workers.size()) + 1; }
+
+    // Runs all tasks and returns when every one of them has finished
+    void run(std::vector<Task>& tasks);
+};
+
+#endif /* WORKSTEALINGPOOL_H_ */
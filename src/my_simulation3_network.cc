@@ -9,23 +9,83 @@
 #include <string.h>
 #include <omnetpp.h>
 #include "SimpleKalmanFilter.h"
+#include "SampleBatch.h"
+#include "EnergyModel.h"
+#include "CheckpointManager.h"
+#include "HubFilters.h"
+#include "PhiloxRng.h"
+#include "Command.h"
+#include "RoutingTable.h"
+#include "TxQueue.h"
+#include "Arq.h"
+#include "FreshnessMonitor.h"
+#include "MemoryMonitor.h"
+#include "SharedMedium.h"
 
 using namespace omnetpp;
 
-class OBN_node : public cSimpleModule {
+class OBN_node : public cSimpleModule, public Checkpointable, public MemoryAccountable {
 protected:
     virtual void initialize() override;
     virtual void handleMessage(cMessage *msg) override;
+    virtual void filterSample(SimpleKalmanFilter& kf, const char *hubLabel, int receivedValue);
     virtual void transmitMessage();
     virtual void backoff();
+    virtual void finish() override;
+    virtual void sendAccounted(cMessage *msg, int gateIndex, TxQueue::Priority priority = TxQueue::DATA);
+    virtual void startTransmission();
+    virtual void transmit(cPacket *pkt, int gateIndex);
+    virtual void checkBattery();
+    virtual void sendCommand();
+    // Acknowledges, deduplicates and unwraps ARQ frames from the hubs
+    virtual cPacket *receiveFrame(ArqFrame *frame, cModule *sender);
+    // Latency, age of information and sequence gaps of a sensor's sample
+    virtual void trackFreshness(int sourceId, long seq, simtime_t generationTime, long suppressed);
+
+    // Checkpointable
+    virtual void saveState(CheckpointWriter& writer) override;
+    virtual void loadState(CheckpointReader& reader) override;
+    virtual bool hasPendingPackets() const override { return txQueue != nullptr && (txQueue->isBusy() || !txQueue->isEmpty()); }
+
+    // MemoryAccountable
+    virtual size_t getMemoryFootprint() const override;
 
     // Existing variables
     int nodeId;
-    double slotDuration = 0.01;
-    bool channelBusy = false;
 
-    // New variable
-    double x; // Variable x
+    // Energy accounting
+    EnergyModel energy;
+    bool batteryDepleted = false;
+
+    // Gate choice and backoff
+    ModuleRng rng;
+
+    // Transmit queues of the radio (nullptr unless txQueueing is set)
+    TxQueue *txQueue = nullptr;
+    cMessage *txDoneMsg = nullptr;
+
+    // Downlink commands, sent round robin to the hubs or sensors
+    RoutingTable routes;
+    std::vector<Command::Type> commandTypes;
+    simtime_t commandInterval;
+    cMessage *commandMsg = nullptr;
+    int nextCommand = 0;
+    long numCommandsSent = 0;
+    long numCommandsUnroutable = 0;
+
+    // Receiving side of the hubs' ARQ links
+    std::map<int, ArqReceiver> arqReceivers; // Keyed by the sender's module id
+    long numCorruptedFrames = 0;
+    long numDuplicateFrames = 0;
+
+    // Freshness of the samples per sensor; every freshnessVectorInterval-th
+    // sample of a sensor is also recorded into its vectors (0 = scalars only)
+    FreshnessMonitor freshness;
+    int freshnessVectorInterval = 0;
+    std::map<int, std::pair<cOutVector *, cOutVector *>> freshnessVectors; // Latency and age, keyed by the sensor's module id
+
+    // Interference with the other transmissions (nullptr = private links)
+    SharedMedium *medium = nullptr;
 
     // Kalman filters for Hub_Node1, Hub_Node2, and Hub_Node3 inputs
     SimpleKalmanFilter kf_hub1;
@@ -34,109 +94,395 @@ protected:
 
 public:
     OBN_node()
-        : x(5.0),
-          // Kalman filter parameters for Hub_Node1
-          kf_hub1(2.0, 2.0, 0.01),
+        : // Kalman filter parameters for Hub_Node1
+          kf_hub1(makeFilter(getHubFilterConfig(0).obnFilter)),
           // Kalman filter parameters for Hub_Node2
-          kf_hub2(2.0, 2.0, 0.01),
+          kf_hub2(makeFilter(getHubFilterConfig(1).obnFilter)),
           // Kalman filter parameters for Hub_Node3
-          kf_hub3(0.5, 0.5, 0.01) {} // Default constructor with x initialized to 5
+          kf_hub3(makeFilter(getHubFilterConfig(2).obnFilter)) {} // Default constructor
+    virtual ~OBN_node();
 
     cMessage *decrementXMsg = nullptr; // Pointer for the self-message
-    double decrementInterval = 0.0005; // Interval in seconds to decrement x
-    double decrementAmount = 0.3; // Amount to decrement x by each interval
+    double decrementInterval = 0.0005; // Interval in seconds of the decrementX timer
 };
 
 Define_Module(OBN_node);
 
+OBN_node::~OBN_node() {
+    cancelAndDelete(txDoneMsg);
+    cancelAndDelete(commandMsg);
+    cancelAndDelete(decrementXMsg);
+    delete txQueue;
+    for (auto& entry : freshnessVectors) {
+        delete entry.second.first;
+        delete entry.second.second;
+    }
+}
+
+size_t OBN_node::getMemoryFootprint() const {
+    size_t bytes = sizeof(*this) + heapBytes(commandTypes) + heapBytes(arqReceivers) + freshness.getHeapBytes()
+                   + heapBytes(freshnessVectors) + freshnessVectors.size() * 2 * sizeof(cOutVector);
+    if (txQueue != nullptr)
+        bytes += sizeof(TxQueue);
+    return bytes;
+}
+
 void OBN_node::initialize() {
     nodeId = atoi(getName());
     EV << "OBN " << nodeId << " initialized\n";
 
-    // Initialize x from a parameter
-    x = par("initialX").doubleValue();
+    energy.configure(par("supplyVoltage"), par("batteryCapacity"), par("txCurrent"), par("rxCurrent"),
+                     par("idleCurrent"), par("sleepCurrent"), par("radioBitrate"));
+    rng.configure(this, par("perModuleRng"));
+
+    if (par("txQueueing").boolValue()) {
+        txQueue = new TxQueue();
+        txQueue->configure(gateSize("output_gate"), par("txQueueCapacity"));
+        txDoneMsg = new cMessage("txDone");
+    }
+
+    freshnessVectorInterval = par("freshnessVectorInterval");
+    medium = SharedMedium::find();
+
+    routes.build(this);
+    cStringTokenizer tokenizer(par("commands").stringValue());
+    while (tokenizer.hasMoreTokens()) {
+        const char *name = tokenizer.nextToken();
+        if (strcmp(name, "setSampleInterval") == 0)
+            commandTypes.push_back(Command::SET_SAMPLE_INTERVAL);
+        else if (strcmp(name, "setProcessNoise") == 0)
+            commandTypes.push_back(Command::SET_PROCESS_NOISE);
+        else if (strcmp(name, "sleep") == 0)
+            commandTypes.push_back(Command::SLEEP);
+        else
+            throw cRuntimeError("Unknown command '%s' in parameter commands", name);
+    }
+    commandInterval = par("commandInterval");
+    if (commandInterval > 0 && !commandTypes.empty()) {
+        commandMsg = new cMessage("command");
+        scheduleAt(simTime() + commandInterval, commandMsg);
+    }
+
+    // Schedule the periodic decrementX self-message; with duty cycling the
+    // OBN stays awake as coordinator but does without the timer
+    if (!par("dutyCycling").boolValue()) {
+        decrementXMsg = new cMessage("decrementX");
+        scheduleAt(simTime() + decrementInterval, decrementXMsg);
+    }
+
+    // A run resumed from a checkpoint continues from the saved state instead of starting up
+    if (CheckpointManager::restore(this))
+        return;
 
     if (nodeId == 0) {
         // Schedule transmission of "Hello There!" message at time 0.0
-        cMessage *msg1 = new cMessage("Hello There!");
-        int gateIndex = intuniform(0, gateSize("output_gate") - 1);
+        cPacket *msg1 = new cPacket("Hello There!");
+        msg1->setByteLength(par("controlPacketLength").intValue());
+        int gateIndex = rng.intuniform(0, gateSize("output_gate") - 1);
         EV << "OBN " << nodeId << " transmitting message: " << msg1->getName() << " on gate " << gateIndex << "\n";
         bubble("Message Transmitted from OBN!");
-        send(msg1, "output_gate", gateIndex);
+        sendAccounted(msg1, gateIndex, TxQueue::CONTROL);
     }
-
-    // Schedule the self-message for decrementing x
-    decrementXMsg = new cMessage("decrementX");
-    scheduleAt(simTime() + decrementInterval, decrementXMsg);
 }
 
 
 void OBN_node::handleMessage(cMessage *msg) {
-    if (msg == decrementXMsg) {
-        // Decrement x and reschedule the message
-        x -= decrementAmount;
-        EV << "OBN " << getName() << " (ID: " << nodeId << ") decremented x to " << x << " at time " << simTime() << ".\n";
-
+    if (msg == txDoneMsg) {
+        txQueue->setBusy(false);
+        startTransmission();
+    } else if (msg == commandMsg) {
+        sendCommand();
+        scheduleAt(simTime() + commandInterval, commandMsg);
+    } else if (msg == decrementXMsg) {
         // No need to cancel the event here since we're within its handling code, and it's automatically unscheduled
         scheduleAt(simTime() + decrementInterval, decrementXMsg);
     } else {
+        if (batteryDepleted) {
+            // A node with an empty battery can no longer receive
+            delete msg;
+            return;
+        }
+        cPacket *pkt = dynamic_cast<cPacket *>(msg);
+        energy.chargeRx(pkt ? pkt->getBitLength() : 0, SIMTIME_DBL(simTime()));
+        checkBattery();
+        if (medium != nullptr && pkt != nullptr && !medium->receive(pkt, this) && !dynamic_cast<ArqFrame *>(pkt) && !dynamic_cast<ArqAck *>(pkt)) {
+            // Lost to interference; ARQ frames and ACKs go on with their bit error flag set
+            delete msg;
+            return;
+        }
+
+        cModule *sender = msg->getSenderModule();
+        if (ArqFrame *frame = dynamic_cast<ArqFrame *>(msg)) {
+            msg = receiveFrame(frame, sender);
+            if (msg == nullptr)
+                return;
+        }
+
         // Perform Kalman filtering based on the source of the message
-        if (strcmp(msg->getSenderModule()->getName(), "Hub_1") == 0) {
+        const char *senderName = sender->getName();
+        SimpleKalmanFilter *kf = nullptr;
+        const char *hubLabel = nullptr;
+        if (strcmp(senderName, "Hub_1") == 0) {
             // Filter input from Hub_Node1
-            int receivedValue = atoi(msg->getName());
-            int filteredValue1 = static_cast<int>(kf_hub1.updateEstimate(receivedValue));
-            int measurementError1 = static_cast<int>(kf_hub1.getEstimateError());
-            EV << "Received value from Hub_Node1: " << receivedValue << ", Predicted value: " << filteredValue1
-               << ", Measurement Error: " << measurementError1 << endl;
-            bubble("Message Received from Hub_Node1!");
-            if (filteredValue1 == receivedValue || std::abs(filteredValue1 - receivedValue) == 10) {
-                transmitMessage();
-            }
-        } else if (strcmp(msg->getSenderModule()->getName(), "Hub_2") == 0) {
+            kf = &kf_hub1;
+            hubLabel = "Hub_Node1";
+        } else if (strcmp(senderName, "Hub_2") == 0) {
             // Filter input from Hub_Node2
-            int receivedValue = atoi(msg->getName());
-            int filteredValue2 = static_cast<int>(kf_hub2.updateEstimate(receivedValue));
-            int measurementError2 = static_cast<int>(kf_hub2.getEstimateError());
-            EV << "Received value from Hub_Node2: " << receivedValue << ", Predicted value: " << filteredValue2
-               << ", Measurement Error: " << measurementError2 << endl;
-            bubble("Message Received from Hub_Node2!");
-            if (filteredValue2 == receivedValue || std::abs(filteredValue2 - receivedValue) == 10) {
-                transmitMessage();
-            }
-        } else if (strcmp(msg->getSenderModule()->getName(), "Hub_3") == 0) {
+            kf = &kf_hub2;
+            hubLabel = "Hub_Node2";
+        } else if (strcmp(senderName, "Hub_3") == 0) {
             // Filter input from Hub_Node3
-            int receivedValue = atoi(msg->getName());
-            int filteredValue3 = static_cast<int>(kf_hub3.updateEstimate(receivedValue));
-            int measurementError3 = static_cast<int>(kf_hub3.getEstimateError());
-            EV << "Received value from Hub_Node3: " << receivedValue << ", Predicted value: " << filteredValue3
-               << ", Measurement Error: " << measurementError3 << endl;
-            bubble("Message Received from Hub_Node3!");
-            if (filteredValue3 == receivedValue || std::abs(filteredValue3 - receivedValue) == 10) {
-                transmitMessage();
+            kf = &kf_hub3;
+            hubLabel = "Hub_Node3";
+        }
+
+        if (kf != nullptr) {
+            if (SampleBatch *batch = dynamic_cast<SampleBatch *>(msg)) {
+                // Aggregate packet from the hub: unpack and filter all samples in this handler call
+                for (const Sample& sample : batch->getSamples()) {
+                    if (sample.seq >= 0)
+                        trackFreshness(sample.sourceId, sample.seq, sample.generationTime, sample.suppressed);
+                    filterSample(*kf, hubLabel, static_cast<int>(sample.value));
+                }
+            } else {
+                if (SensorSample *sample = dynamic_cast<SensorSample *>(msg))
+                    trackFreshness(sample->getSourceId(), sample->getSeq(), sample->getGenerationTime(), sample->getSuppressed());
+                filterSample(*kf, hubLabel, atoi(msg->getName()));
             }
+            bubble((std::string("Message Received from ") + hubLabel + "!").c_str());
         }
+        delete msg;
 
         // Check if decrementXMsg is already scheduled, cancel it before rescheduling
-        if (decrementXMsg->isScheduled()) {
-            cancelEvent(decrementXMsg);
+        if (decrementXMsg != nullptr) {
+            if (decrementXMsg->isScheduled())
+                cancelEvent(decrementXMsg);
+            scheduleAt(simTime() + decrementInterval, decrementXMsg);
         }
-        scheduleAt(simTime() + decrementInterval, decrementXMsg);
     }
 }
 
+void OBN_node::filterSample(SimpleKalmanFilter& kf, const char *hubLabel, int receivedValue) {
+    int filteredValue = static_cast<int>(kf.updateEstimate(receivedValue));
+    int measurementError = static_cast<int>(kf.getEstimateError());
+    EV << "Received value from " << hubLabel << ": " << receivedValue << ", Predicted value: " << filteredValue
+       << ", Measurement Error: " << measurementError << endl;
+    if (isForwarded(filteredValue - receivedValue)) {
+        transmitMessage();
+    }
+}
+
+void OBN_node::trackFreshness(int sourceId, long seq, simtime_t generationTime, long suppressed) {
+    double latency, age;
+    freshness.collect(sourceId, seq, SIMTIME_DBL(generationTime), suppressed, SIMTIME_DBL(simTime()), latency, age);
+    if (freshnessVectorInterval <= 0 || (freshness.getSources().at(sourceId).received - 1) % freshnessVectorInterval != 0)
+        return;
+
+    auto it = freshnessVectors.find(sourceId);
+    if (it == freshnessVectors.end()) {
+        // Vectors are created on the first sample, so that only sensors that are heard get one
+        std::string sensorName = getSimulation()->getModule(sourceId)->getFullName();
+        cOutVector *latencyVector = new cOutVector(("e2eLatency:" + sensorName).c_str());
+        cOutVector *ageVector = new cOutVector(("ageOfInformation:" + sensorName).c_str());
+        latencyVector->setUnit("s");
+        ageVector->setUnit("s");
+        it = freshnessVectors.emplace(sourceId, std::make_pair(latencyVector, ageVector)).first;
+    }
+    it->second.first->record(latency);
+    it->second.second->record(age);
+}
+
 void OBN_node::transmitMessage() {
     // Create and send the message
-    cMessage *msg1 = new cMessage("Hello There!");
-    int gateIndex = intuniform(0, gateSize("output_gate") - 1);
+    cPacket *msg1 = new cPacket("Hello There!");
+    msg1->setByteLength(par("controlPacketLength").intValue());
+    int gateIndex = rng.intuniform(0, gateSize("output_gate") - 1);
     EV << "OBN " << nodeId << " transmitting message: " << msg1->getName() << " on gate " << gateIndex << "\n";
     bubble("Message Transmitted from OBN!");
-    send(msg1, "output_gate", gateIndex);
+    sendAccounted(msg1, gateIndex, TxQueue::CONTROL);
+}
+
+void OBN_node::sendCommand() {
+    // Commands cycle through the configured types; sensor commands go to the
+    // nodes two hops away, filter commands to the hubs
+    Command::Type type = commandTypes[nextCommand % commandTypes.size()];
+    std::vector<int> destinations = routes.getDestinations(type == Command::SET_PROCESS_NOISE ? 1 : 2);
+    if (destinations.empty()) {
+        numCommandsUnroutable++;
+        nextCommand++;
+        return;
+    }
+    int destination = destinations[(nextCommand / commandTypes.size()) % destinations.size()];
+    nextCommand++;
+
+    double value = 0;
+    switch (type) {
+        case Command::SET_SAMPLE_INTERVAL: value = par("commandSampleInterval").doubleValue(); break;
+        case Command::SET_PROCESS_NOISE: value = par("commandProcessNoise").doubleValue(); break;
+        case Command::SLEEP: value = par("commandSleepDuration").doubleValue(); break;
+    }
+
+    char msgname[40];
+    sprintf(msgname, "%s-%d", Command::getTypeName(type), destination);
+    Command *command = new Command(msgname, type, destination, value);
+    command->setByteLength(par("controlPacketLength").intValue());
+    EV << "OBN " << nodeId << " sending command " << msgname << " (value " << value << ")\n";
+    numCommandsSent++;
+    sendAccounted(command, routes.lookup(destination), TxQueue::CONTROL);
+}
+
+cPacket *OBN_node::receiveFrame(ArqFrame *frame, cModule *sender) {
+    if (frame->hasBitError()) {
+        // Corrupted frames are not acknowledged; the hub retransmits
+        numCorruptedFrames++;
+        delete frame;
+        return nullptr;
+    }
+
+    // Every intact frame is acknowledged, duplicates too, as their first ACK may have been lost
+    int gateIndex = routes.lookup(sender->par("nodeId").intValue());
+    if (gateIndex >= 0) {
+        ArqAck *ack = new ArqAck("ack", frame->getSeq());
+        ack->setByteLength(par("controlPacketLength").intValue());
+        sendAccounted(ack, gateIndex, TxQueue::CONTROL);
+    }
+
+    if (!arqReceivers[sender->getId()].accept(frame)) {
+        numDuplicateFrames++;
+        delete frame;
+        return nullptr;
+    }
+    cPacket *pkt = frame->decapsulate();
+    delete frame;
+    return pkt;
+}
+
+void OBN_node::sendAccounted(cMessage *msg, int gateIndex, TxQueue::Priority priority) {
+    if (batteryDepleted) {
+        delete msg;
+        return;
+    }
+    cPacket *pkt = check_and_cast<cPacket *>(msg);
+    if (txQueue == nullptr) {
+        transmit(pkt, gateIndex);
+        return;
+    }
+    // A full link queue drops the new packet or displaces a lower priority one
+    delete txQueue->enqueue(pkt, gateIndex, priority, SIMTIME_DBL(simTime()));
+    if (!txQueue->isBusy())
+        startTransmission();
+}
+
+void OBN_node::startTransmission() {
+    int gateIndex;
+    cPacket *pkt = txQueue->dequeue(gateIndex, SIMTIME_DBL(simTime()));
+    if (pkt == nullptr)
+        return;
+    if (batteryDepleted) {
+        delete pkt;
+        return;
+    }
+    // The radio is busy for the packet's airtime
+    txQueue->setBusy(true);
+    scheduleAt(simTime() + energy.getAirtime(pkt->getBitLength()), txDoneMsg);
+    transmit(pkt, gateIndex);
+}
+
+void OBN_node::transmit(cPacket *pkt, int gateIndex) {
+    energy.chargeTx(pkt->getBitLength(), SIMTIME_DBL(simTime()));
+    checkBattery();
+    if (medium != nullptr)
+        medium->transmit(this, pkt, gateIndex, energy.getAirtime(pkt->getBitLength()));
+    send(pkt, "output_gate", gateIndex);
+}
+
+void OBN_node::checkBattery() {
+    if (batteryDepleted || !energy.isDepleted())
+        return;
+    batteryDepleted = true;
+    EV << "OBN " << nodeId << " battery depleted at t=" << energy.getDepletionTime() << "s\n";
+    bubble("Battery depleted!");
+}
+
+void OBN_node::finish() {
+    energy.recordScalars(this, SIMTIME_DBL(simTime()));
+    if (txQueue != nullptr)
+        txQueue->recordScalars(this, SIMTIME_DBL(simTime()));
+    if (!arqReceivers.empty()) {
+        recordScalar("arqCorruptedFrames", numCorruptedFrames);
+        recordScalar("arqDuplicateFrames", numDuplicateFrames);
+    }
+    freshness.recordScalars(this, SIMTIME_DBL(simTime()), [this](int sourceId) {
+        cModule *sensor = getSimulation()->getModule(sourceId);
+        return std::string(sensor ? sensor->getFullName() : "unknown");
+    });
+    if (commandMsg != nullptr) {
+        recordScalar("commandsSent", numCommandsSent);
+        recordScalar("commandsUnroutable", numCommandsUnroutable);
+    }
 }
 
 void OBN_node::backoff() {
     // Simple backoff mechanism
     // For simplicity, just wait for a random time within a range
-    double backoffTime = uniform(0, 0.1); // Adjust the range as needed
+    double backoffTime = rng.uniform(0, 0.1); // Adjust the range as needed
     EV << "OBN " << nodeId << " backing off for " << backoffTime << "s\n";
     wait(backoffTime);
 }
+
+void OBN_node::saveState(CheckpointWriter& writer) {
+    kf_hub1.saveState(writer);
+    kf_hub2.saveState(writer);
+    kf_hub3.saveState(writer);
+    energy.saveState(writer, SIMTIME_DBL(simTime()));
+    writer.putBool(batteryDepleted);
+    rng.saveState(writer);
+    // Written only when enabled, so a checkpoint must be restored with the same configuration
+    if (txQueue != nullptr)
+        txQueue->saveState(writer, SIMTIME_DBL(simTime()));
+    writer.putInt(nextCommand);
+    writer.putLong(numCommandsSent);
+    writer.putLong(numCommandsUnroutable);
+    writer.putInt(static_cast<int>(arqReceivers.size()));
+    for (const auto& entry : arqReceivers) {
+        writer.putInt(entry.first);
+        entry.second.saveState(writer);
+    }
+    writer.putLong(numCorruptedFrames);
+    writer.putLong(numDuplicateFrames);
+    freshness.saveState(writer, SIMTIME_DBL(simTime()));
+    writer.putDouble(CheckpointManager::remainingTime(commandMsg));
+    writer.putDouble(CheckpointManager::remainingTime(decrementXMsg));
+}
+
+void OBN_node::loadState(CheckpointReader& reader) {
+    kf_hub1.loadState(reader);
+    kf_hub2.loadState(reader);
+    kf_hub3.loadState(reader);
+    energy.loadState(reader, SIMTIME_DBL(simTime()));
+    batteryDepleted = reader.getBool();
+    rng.loadState(reader);
+    if (txQueue != nullptr)
+        txQueue->loadState(reader, SIMTIME_DBL(simTime()));
+    nextCommand = reader.getInt();
+    numCommandsSent = reader.getLong();
+    numCommandsUnroutable = reader.getLong();
+    int numReceivers = reader.getInt();
+    for (int i = 0; i < numReceivers; i++) {
+        int senderId = reader.getInt();
+        arqReceivers[senderId].loadState(reader);
+    }
+    numCorruptedFrames = reader.getLong();
+    numDuplicateFrames = reader.getLong();
+    freshness.loadState(reader, SIMTIME_DBL(simTime()));
+    double commandRemaining = reader.getDouble();
+    if (commandMsg != nullptr && commandMsg->isScheduled())
+        cancelEvent(commandMsg);
+    if (commandRemaining >= 0 && commandMsg != nullptr)
+        scheduleAt(simTime() + commandRemaining, commandMsg);
+    double remaining = reader.getDouble();
+    if (decrementXMsg != nullptr && decrementXMsg->isScheduled())
+        cancelEvent(decrementXMsg);
+    if (decrementXMsg != nullptr && remaining >= 0)
+        scheduleAt(simTime() + remaining, decrementXMsg);
+}
@@ -10,13 +10,31 @@
 #include <omnetpp.h>
 #include <fstream>
 #include <vector>
-#include <numeric> // Add this header for accumulate function
 
 using namespace omnetpp;
 
 #include "SimpleKalmanFilter.h"
-
-class Hub_node1 : public cSimpleModule {
+#include "SampleBatch.h"
+#include "EnergyModel.h"
+#include "CheckpointManager.h"
+#include "SteadyStateDetector.h"
+#include "HubFilters.h"
+#include "ParallelHubDispatcher.h"
+#include "PhiloxRng.h"
+#include "Command.h"
+#include "RoutingTable.h"
+#include "TxQueue.h"
+#include "Arq.h"
+#include "MemoryMonitor.h"
+#include "SharedMedium.h"
+#include "Beacon.h"
+#include "MetricsExporter.h"
+
+// Common behaviour of Hub_node1, Hub_node2 and Hub_node3. The hubs only differ
+// in which child nodes they expect and in the Kalman filters they run, which
+// come from their entry in the hub filter configuration (HubFilters.h).
+class HubNode : public cSimpleModule, public Checkpointable, public ConcurrentFilterClient, public MemoryAccountable,
+                public MetricsProvider {
 protected:
     virtual void initialize() override;
     virtual void handleMessage(cMessage *msg) override;
@@ -24,31 +42,255 @@ protected:
     virtual void backoff();
     virtual void finish() override; // Added for data collection and plotting
 
-    // Existing variables
+    // Runs the Kalman filter belonging to the given child node; returns false
+    // if the sender is not one of this hub's children
+    virtual bool filterSample(const char *senderName, double receivedValue, double& filteredValue);
+
+    // ConcurrentFilterClient; used instead of filtering inline when the
+    // samples are handed to the ParallelHubDispatcher
+    virtual bool filterConcurrently(const char *senderName, double receivedValue, double& filteredValue) override;
+    virtual void applyFilterResult(cMessage *msg, cModule *sender, double receivedValue,
+                                   double filteredValue, bool known) override;
+
+    // Forwarding towards the OBN, either directly or through the aggregation stage
+    virtual void forwardToObn(cMessage *msg, int sourceId, double receivedValue);
+    virtual void flushBatch();
+
+    // ARQ: data to the OBN goes through arqSender, frames from the sensors
+    // are acknowledged, deduplicated and unwrapped
+    virtual void sendReliable(cPacket *pkt, int gateIndex);
+    virtual cPacket *receiveFrame(ArqFrame *frame, cModule *sender);
+    virtual void handleAck(ArqAck *ack);
+    virtual void retransmitExpired();
+    virtual void scheduleArqTimer();
+
+    // Sends on the given output gate and charges the transmission to the
+    // battery; with txQueueing the packet waits for the radio in txQueue
+    virtual void sendAccounted(cMessage *msg, int gateIndex, TxQueue::Priority priority = TxQueue::DATA);
+    virtual void startTransmission();
+    virtual void transmit(cPacket *pkt, int gateIndex);
+    virtual void checkBattery();
+
+    // Downlink: executes commands addressed to this hub, relays the others
+    virtual void handleCommand(Command *command);
+    virtual void setProcessNoise(float q);
+
+    // Duty cycling: superframeMsg alternates between the two
+    virtual void startSuperframe();
+    virtual void endActivePeriod();
+
+    // Records a prediction error unless it falls into the warm-up period
+    virtual void collectPredictionError(double predictionError);
+    virtual void checkPrecision();
+
+    // Checkpointable
+    virtual void saveState(CheckpointWriter& writer) override;
+    virtual void loadState(CheckpointReader& reader) override;
+    virtual bool hasPendingPackets() const override;
+
+    // MemoryAccountable
+    virtual size_t getMemoryFootprint() const override;
+
+    // MetricsProvider: prediction error and forwarding so far
+    virtual void collectMetrics(std::vector<Metric>& metrics) const override;
+
+    // Hot state, used for every sample
     int nodeId;
-    double slotDuration = 0.01;
-    bool channelBusy = false;
-
-    // New variables for data collection and plotting
-    std::vector<double> predictionErrors;
+    bool precisionReached = false;
+    bool batteryDepleted = false;
+    bool arq = false;
+    int warmupSamples = 0;
+    int precisionCheckInterval = 100;
+    int aggregationSize = 1;
+    long numSamplesFiltered = 0;
+    long numWarmupSamples = 0;
+    long numSamplesForwarded = 0;
+    long numPacketsToObn = 0;
+    std::map<int, long> suppressedBySource; // Samples not forwarded, keyed by the sensor's module id
+    double targetRelativePrecision = 0;
+
+    // Kalman filters of the child nodes
+    HubFilters filters;
+
+    // Prediction errors after the warm-up, summarised online
+    cHistogram predictionErrorHistogram;
     cOutVector predictionErrorVector;
-
-    // Kalman filter for Node_11 and Node_12 inputs
-    SimpleKalmanFilter kf_node11;
-    SimpleKalmanFilter kf_node12;
+    SteadyStateDetector steadyState;
+
+    // Every prediction error, kept only while checkpoints are written so that
+    // a restored run can rebuild its histogram (nullptr otherwise)
+    std::vector<double> *predictionErrorLog = nullptr;
+
+    // Aggregation of forwarded samples (disabled when aggregationSize <= 1)
+    simtime_t aggregationMaxLatency;
+    SampleBatch *pendingBatch = nullptr;
+    cMessage *flushBatchMsg = nullptr;
+
+    // Energy accounting
+    EnergyModel energy;
+
+    // Gate choice and backoff
+    ModuleRng rng;
+
+    // Filtering on the dispatcher's thread pool (nullptr = filter inline)
+    ParallelHubDispatcher *dispatcher = nullptr;
+
+    // Interference with the other transmissions (nullptr = private links)
+    SharedMedium *medium = nullptr;
+
+    // Duty cycling: awake for activePeriod at the start of every superframe,
+    // asleep with the radio off for the rest of it
+    bool dutyCycling = false;
+    bool asleep = false;
+    simtime_t superframeInterval;
+    simtime_t activePeriod;
+    cMessage *superframeMsg = nullptr;
+    long numSuperframes = 0;
+    long numPacketsMissedAsleep = 0;
+
+    // Cold state: optional features, allocated only when used
+
+    // Transmit queues of the radio (nullptr unless txQueueing is set)
+    TxQueue *txQueue = nullptr;
+    cMessage *txDoneMsg = nullptr;
+
+    // Downlink commands; hubs are addressed by their nodeId parameter
+    RoutingTable routes;
+    int address = -1;
+    long numCommandsReceived = 0;
+    long numCommandsRelayed = 0;
+    long numCommandsUnroutable = 0;
+    double commandLatencySum = 0;
+    cOutVector *commandLatencyVector = nullptr;
+
+    // Link-layer retransmissions (nullptr unless arq is set)
+    int arqHeaderLength = 0;
+    ArqSender *arqSender = nullptr;
+    cMessage *arqTimerMsg = nullptr;
+    std::map<int, ArqReceiver> arqReceivers; // Keyed by the sender's module id
+    long numCorruptedFrames = 0;
+    long numDuplicateFrames = 0;
 
 public:
-    Hub_node1() : nodeId(0), kf_node11(2.0, 2.0, 0.01), kf_node12(2.0, 2.0, 0.01) {} // Default constructor
+    explicit HubNode(int hub) : nodeId(0), filters(hub), predictionErrorHistogram("Prediction Error") {}
+    virtual ~HubNode();
+    bool isPrecisionReached() const { return precisionReached; }
     cMessage *decrementXMsg = nullptr; // Pointer for the self-message
     double decrementInterval = 0.0005; // Interval in seconds to decrement x
-    double decrementAmount = 0.3; // Amount to decrement x by each interval
 };
 
-Define_Module(Hub_node1);
+HubNode::~HubNode()
+{
+    cancelAndDelete(decrementXMsg);
+    cancelAndDelete(superframeMsg);
+    cancelAndDelete(flushBatchMsg);
+    cancelAndDelete(txDoneMsg);
+    cancelAndDelete(arqTimerMsg);
+    delete pendingBatch;
+    delete txQueue;
+    delete arqSender;
+    delete commandLatencyVector;
+    delete predictionErrorLog;
+}
+
+bool HubNode::hasPendingPackets() const
+{
+    return (txQueue != nullptr && (txQueue->isBusy() || !txQueue->isEmpty())) || (arqSender != nullptr && !arqSender->isEmpty());
+}
+
+size_t HubNode::getMemoryFootprint() const
+{
+    size_t bytes = sizeof(HubNode) + filters.getHeapBytes() + steadyState.getHeapBytes() + heapBytes(arqReceivers) + heapBytes(suppressedBySource);
+    if (predictionErrorLog != nullptr)
+        bytes += sizeof(*predictionErrorLog) + heapBytes(*predictionErrorLog);
+    if (pendingBatch != nullptr)
+        bytes += sizeof(SampleBatch) + heapBytes(pendingBatch->getSamples());
+    if (txQueue != nullptr)
+        bytes += sizeof(TxQueue);
+    if (arqSender != nullptr)
+        bytes += sizeof(ArqSender);
+    if (commandLatencyVector != nullptr)
+        bytes += sizeof(cOutVector);
+    return bytes;
+}
 
-void Hub_node1::initialize() {
+void HubNode::collectMetrics(std::vector<Metric>& metrics) const
+{
+    long count = predictionErrorHistogram.getCount();
+    metrics.push_back({"hub_prediction_error_mean", "Mean prediction error after the warm-up", count > 0 ? predictionErrorHistogram.getMean() : NAN, false});
+    metrics.push_back({"hub_samples_filtered_total", "Samples filtered, including the warm-up", static_cast<double>(numSamplesFiltered), true});
+    metrics.push_back({"hub_samples_forwarded_total", "Samples forwarded to the OBN", static_cast<double>(numSamplesForwarded), true});
+    metrics.push_back({"hub_forwarded_ratio", "Share of the filtered samples forwarded to the OBN", numSamplesFiltered > 0 ? static_cast<double>(numSamplesForwarded) / numSamplesFiltered : NAN, false});
+}
+
+void HubNode::initialize() {
     nodeId = atoi(getName());
-    EV << "Hub_node1 " << nodeId << " initialized\n";
+    EV << getClassName() << " " << nodeId << " initialized\n";
+
+    // A duty-cycled hub has no periodic timer besides its superframes
+    dutyCycling = par("dutyCycling");
+    if (dutyCycling) {
+        superframeInterval = par("superframeInterval");
+        activePeriod = par("activePeriod");
+        if (activePeriod <= 0 || activePeriod >= superframeInterval)
+            throw cRuntimeError("activePeriod must be positive and shorter than superframeInterval");
+        superframeMsg = new cMessage("superframe");
+    } else {
+        decrementXMsg = new cMessage("decrementX");
+        scheduleAt(simTime() + decrementInterval, decrementXMsg);
+    }
+
+    energy.configure(par("supplyVoltage"), par("batteryCapacity"), par("txCurrent"), par("rxCurrent"),
+                     par("idleCurrent"), par("sleepCurrent"), par("radioBitrate"));
+    rng.configure(this, par("perModuleRng"));
+
+    if (par("txQueueing").boolValue()) {
+        txQueue = new TxQueue();
+        txQueue->configure(gateSize("output_gate"), par("txQueueCapacity"));
+        txDoneMsg = new cMessage("txDone");
+    }
+    routes.build(this);
+    address = par("nodeId");
+
+    arq = par("arq");
+    if (arq) {
+        arqSender = new ArqSender();
+        arqSender->configure(par("arqBufferSize"), par("arqTimeout"), par("maxPacketTries"));
+        arqHeaderLength = par("arqHeaderLength");
+        arqTimerMsg = new cMessage("arqTimeout");
+    }
+    medium = SharedMedium::find();
+
+    warmupSamples = par("warmupSamples");
+    precisionCheckInterval = par("precisionCheckInterval");
+    if (precisionCheckInterval < 1)
+        throw cRuntimeError("precisionCheckInterval must be at least 1");
+    targetRelativePrecision = par("targetRelativePrecision");
+
+    aggregationSize = par("aggregationSize");
+    aggregationMaxLatency = par("aggregationMaxLatency");
+    if (aggregationSize > 1)
+        flushBatchMsg = new cMessage("flushBatch");
+
+    if (par("parallelProcessing").boolValue()) {
+        dispatcher = ParallelHubDispatcher::find();
+        if (dispatcher == nullptr)
+            throw cRuntimeError("parallelProcessing requires a ParallelHubDispatcher named 'hubDispatcher' in the network");
+    }
+
+    // Registering the vector for data collection
+    predictionErrorVector.setName("PredictionError");
+    if (CheckpointManager::isCheckpointing())
+        predictionErrorLog = new std::vector<double>();
+
+    // A run resumed from a checkpoint continues from the saved state instead of starting up
+    if (CheckpointManager::restore(this))
+        return;
+
+    if (superframeMsg != nullptr) {
+        asleep = true; // Until the first superframe starts at t=0
+        scheduleAt(simTime(), superframeMsg);
+    }
 
     // Initialize x from a parameter
     if (nodeId == 0) {
@@ -57,23 +299,77 @@ void Hub_node1::initialize() {
         cMessage *msg = new cMessage(msgname);
         scheduleAt(0.0, msg);
     }
-    decrementXMsg = new cMessage("decrementX");
-    scheduleAt(simTime() + decrementInterval, decrementXMsg);
-
-    // Registering the vector for data collection
-    predictionErrorVector.setName("PredictionError");
 }
 
-void Hub_node1::handleMessage(cMessage *msg)
+void HubNode::handleMessage(cMessage *msg)
 {
+    if (msg == flushBatchMsg) {
+        // Maximum latency of the pending batch reached
+        flushBatch();
+        return;
+    }
+    if (msg == txDoneMsg) {
+        txQueue->setBusy(false);
+        startTransmission();
+        return;
+    }
+    if (msg == arqTimerMsg) {
+        retransmitExpired();
+        return;
+    }
+    if (msg == superframeMsg) {
+        if (asleep)
+            startSuperframe();
+        else
+            endActivePeriod();
+        return;
+    }
+
+    if (!msg->isSelfMessage()) {
+        if (batteryDepleted) {
+            // A node with an empty battery can no longer receive
+            delete msg;
+            return;
+        }
+        if (asleep) {
+            // The radio is off between the active periods
+            numPacketsMissedAsleep++;
+            delete msg;
+            return;
+        }
+        cPacket *pkt = dynamic_cast<cPacket *>(msg);
+        energy.chargeRx(pkt ? pkt->getBitLength() : 0, SIMTIME_DBL(simTime()));
+        checkBattery();
+        if (medium != nullptr && pkt != nullptr && !medium->receive(pkt, this) && !dynamic_cast<ArqFrame *>(pkt) && !dynamic_cast<ArqAck *>(pkt)) {
+            // Lost to interference; ARQ frames and ACKs go on with their bit error flag set
+            delete msg;
+            return;
+        }
+    }
+
+    if (Command *command = dynamic_cast<Command *>(msg)) {
+        handleCommand(command);
+        return;
+    }
+    if (ArqAck *ack = dynamic_cast<ArqAck *>(msg)) {
+        handleAck(ack);
+        return;
+    }
+    cModule *sender = msg->getSenderModule();
+    if (ArqFrame *frame = dynamic_cast<ArqFrame *>(msg)) {
+        msg = receiveFrame(frame, sender);
+        if (msg == nullptr)
+            return;
+    }
+
     // Check if the message received is "Hello There!"
-    if (strcmp(msg->getSenderModule()->getName(), "OBN") == 0) {
+    if (strcmp(sender->getName(), "OBN") == 0) {
         EV << "Received 'Hello There!' message from the OBN. Starting message transmission.\n";
         // Start transmitting messages
         transmitMessage();
     } else {
         // Handle other messages here
-        EV << "Hub_node1 " << getName() << " received a message, but waiting for 'Hello There!' from the OBN.\n";
+        EV << getClassName() << " " << getName() << " received a message, but waiting for 'Hello There!' from the OBN.\n";
         // Store the received message and handle it later
         // Example: storeMessage(msg);
     }
@@ -84,372 +380,569 @@ void Hub_node1::handleMessage(cMessage *msg)
     } else {
         // Handle other messages
         double receivedValue = atof(msg->getName());
-        double filteredValue;
-        bool transmitData = false;
 
-        // Perform Kalman filtering on the input
-        if (strcmp(msg->getSenderModule()->getName(), "Node_11") == 0) {
-            // Filter input from Node_11
-            filteredValue = kf_node11.updateEstimate(receivedValue);
-            EV << "Received value from Node_11: " << receivedValue << ", Predicted value: " << filteredValue << endl;
-            EV << "Node 11 data received at Hub_1.\n";
-        } else if (strcmp(msg->getSenderModule()->getName(), "Node_12") == 0) {
-            // Filter input from Node_12
-            filteredValue = kf_node12.updateEstimate(receivedValue);
-            EV << "Received value from Node_12: " << receivedValue << ", Predicted value: " << filteredValue << endl;
-            EV << "Node 12 data received at Hub_1.\n";
-        } else {
-            // Handle other messages here
-            EV << "Received a message from unexpected sender: " << msg->getSenderModule()->getName() << ".\n";
-            // Handle the message according to your application logic
+        if (dispatcher != nullptr) {
+            // Filtered together with the other hubs' samples of this time instant
+            dispatcher->enqueue(this, this, msg, sender, receivedValue);
+            return;
         }
 
-        // Logic for data transmission based on Kalman Filter output
-        double predictionError = std::abs(filteredValue - receivedValue);
-        predictionErrors.push_back(predictionError);
-        predictionErrorVector.record(predictionError);
-
-        if (predictionError == 0 || std::abs(predictionError) == 10) {
-            transmitData = true;
-            EV << "Data transmitted from " << msg->getSenderModule()->getName() << " to OBN node.\n";
-        } else {
-            EV << "Data not transmitted from " << msg->getSenderModule()->getName() << " to OBN node.\n";
-        }
-
-        if (transmitData) {
-            // Forward the message to OBN_node
-            send(msg, "output_gate", 2); // Assuming output_gate[2] is the gate connected to OBN_node
-        }
+        // Perform Kalman filtering on the input
+        double filteredValue = 0;
+        bool known = filterSample(sender->getName(), receivedValue, filteredValue);
+        applyFilterResult(msg, sender, receivedValue, filteredValue, known);
     }
 }
 
-void Hub_node1::transmitMessage()
+bool HubNode::filterSample(const char *senderName, double receivedValue, double& filteredValue)
 {
-    // Create and send the message
-    cMessage *msg1 = new cMessage("Hello There!");
-    int gateIndex = intuniform(0, gateSize("output_gate") - 1);
-    EV << "Hub_node1 " << nodeId << " transmitting message: " << msg1->getName() << " on gate " << gateIndex << "\n";
-    send(msg1, "output_gate", gateIndex);
+    int child = filters.findChild(senderName);
+    if (child < 0)
+        return false;
+    filteredValue = filters.filter(child, receivedValue);
+    return true;
 }
 
-void Hub_node1::backoff()
+void HubNode::setProcessNoise(float q)
 {
-    // Simple backoff mechanism (you can replace this with CSMA/CA or other algorithms)
-    // For simplicity, just wait for a random time within a range
-    double backoffTime = uniform(0, 0.1); // Adjust the range as needed
-    EV << "Hub_node1 " << nodeId << " backing off for " << backoffTime << "s\n";
-    wait(backoffTime);
+    filters.setProcessNoise(q);
 }
 
-void Hub_node1::finish()
+bool HubNode::filterConcurrently(const char *senderName, double receivedValue, double& filteredValue)
 {
-    // At the end of the simulation, calculate statistics on the collected data
-    // For example, mean, standard deviation, etc.
-    double sum = std::accumulate(predictionErrors.begin(), predictionErrors.end(), 0.0);
-    double mean = sum / predictionErrors.size();
-
-    EV << "Mean Prediction Error: " << mean << endl;
-
-    // Plotting the data using built-in OMNeT++ capabilities
-    // Make sure to enable result recording in the ini file with "record-eventlog = true"
-    EV << "Plotting Prediction Error data...\n";
-    cHistogram hist("Prediction Error");
-    // hist.setRangeAutoUpper(0); // Remove this line as it's causing an error
-    for (double error : predictionErrors) {
-        hist.collect(error);
-    }
-    hist.recordAs("PredictionError");
+    // Runs on a worker thread: filterSample() only touches this hub's filters
+    return filterSample(senderName, receivedValue, filteredValue);
 }
 
-// Hub_node2:
-
-class Hub_node2 : public cSimpleModule {
-protected:
-    virtual void initialize() override;
-    virtual void handleMessage(cMessage *msg) override;
-    virtual void transmitMessage();
-    virtual void backoff();
-    virtual void finish() override; // Added for data collection and plotting
-
-    // Existing variables
-    int nodeId;
-    double slotDuration = 0.01;
-    bool channelBusy = false;
-
-    // New variables for data collection and plotting
-    std::vector<double> predictionErrors;
-    cOutVector predictionErrorVector;
-
-    // Kalman filter for Node_21 and Node_22 inputs
-    SimpleKalmanFilter kf_node21;
-    SimpleKalmanFilter kf_node22;
-
-public:
-    Hub_node2() : nodeId(0), kf_node21(2.0, 2.0, 0.01), kf_node22(2.0, 2.0, 0.01) {} // Default constructor
-    cMessage *decrementXMsg = nullptr; // Pointer for the self-message
-    double decrementInterval = 0.0005; // Interval in seconds to decrement x
-    double decrementAmount = 0.3; // Amount to decrement x by each interval
-};
+void HubNode::applyFilterResult(cMessage *msg, cModule *sender, double receivedValue,
+                                double filteredValue, bool known)
+{
+    Enter_Method_Silent();
+    const char *senderName = sender->getName();
 
-Define_Module(Hub_node2);
+    if (!known) {
+        // Handle other messages here
+        EV << "Received a message from unexpected sender: " << senderName << ".\n";
+        delete msg;
+        return;
+    }
+    EV << "Received value from " << senderName << ": " << receivedValue << ", Predicted value: " << filteredValue << endl;
+    EV << senderName << " data received at " << getName() << ".\n";
 
-void Hub_node2::initialize() {
-    nodeId = atoi(getName());
-    EV << "Hub_node2 " << nodeId << " initialized\n";
+    // Logic for data transmission based on Kalman Filter output
+    FilterOutcome outcome = evaluatePrediction(filteredValue, receivedValue);
+    collectPredictionError(outcome.predictionError);
 
-    // Initialize x from a parameter
-    if (nodeId == 0) {
-        char msgname[20];
-        sprintf(msgname, "Hello-%d", nodeId);
-        cMessage *msg = new cMessage(msgname);
-        scheduleAt(0.0, msg);
+    if (outcome.forwarded) {
+        EV << "Data transmitted from " << senderName << " to OBN node.\n";
+        // Forward the message to OBN_node
+        forwardToObn(msg, sender->getId(), receivedValue);
+    } else {
+        EV << "Data not transmitted from " << senderName << " to OBN node.\n";
+        suppressedBySource[sender->getId()]++;
+        delete msg;
     }
-    decrementXMsg = new cMessage("decrementX");
-    scheduleAt(simTime() + decrementInterval, decrementXMsg);
-
-    // Registering the vector for data collection
-    predictionErrorVector.setName("PredictionError");
 }
 
-void Hub_node2::handleMessage(cMessage *msg)
+void HubNode::collectPredictionError(double predictionError)
 {
-    // Check if the message received is "Hello There!"
-    if (strcmp(msg->getSenderModule()->getName(), "OBN") == 0) {
-        EV << "Received 'Hello There!' message from the OBN. Starting message transmission.\n";
-        // Start transmitting messages
-        transmitMessage();
-    } else {
-        // Handle other messages here
-        EV << "Hub_node2 " << getName() << " received a message, but waiting for 'Hello There!' from the OBN.\n";
-        // Store the received message and handle it later
-        // Example: storeMessage(msg);
+    // Leave out the filter convergence transient: everything before the
+    // warm-up period of the run and the first warmupSamples samples
+    numSamplesFiltered++;
+    if (simTime() < getSimulation()->getWarmupPeriod() || numSamplesFiltered <= warmupSamples) {
+        numWarmupSamples++;
+        return;
     }
+    predictionErrorHistogram.collect(predictionError);
+    if (predictionErrorLog != nullptr)
+        predictionErrorLog->push_back(predictionError);
+    predictionErrorVector.record(predictionError);
+    steadyState.collect(predictionError);
+
+    if (targetRelativePrecision > 0 && !precisionReached && predictionErrorHistogram.getCount() % precisionCheckInterval == 0)
+        checkPrecision();
+}
 
-    if (msg == decrementXMsg) {
-        // No need to cancel the event here since we're within its handling code, and it's automatically unscheduled
-        scheduleAt(simTime() + decrementInterval, decrementXMsg);
-    } else {
-        // Handle other messages
-        double receivedValue = atof(msg->getName());
-        double filteredValue;
-        bool transmitData = false;
-
-        // Perform Kalman filtering on the input
-        if (strcmp(msg->getSenderModule()->getName(), "Node_21") == 0) {
-            // Filter input from Node_21
-            filteredValue = kf_node21.updateEstimate(receivedValue);
-            EV << "Received value from Node_21: " << receivedValue << ", Predicted value: " << filteredValue << endl;
-            EV << "Node 21 data received at Hub_2.\n";
-        } else if (strcmp(msg->getSenderModule()->getName(), "Node_22") == 0) {
-            // Filter input from Node_22
-            filteredValue = kf_node22.updateEstimate(receivedValue);
-            EV << "Received value from Node_22: " << receivedValue << ", Predicted value: " << filteredValue << endl;
-            EV << "Node 22 data received at Hub_2.\n";
-        } else {
-            // Handle other messages here
-            EV << "Received a message from unexpected sender: " << msg->getSenderModule()->getName() << ".\n";
-            // Handle the message according to your application logic
-        }
+static bool allHubsReachedPrecision(cModule *module)
+{
+    for (cModule::SubmoduleIterator it(module); !it.end(); ++it) {
+        HubNode *hub = dynamic_cast<HubNode *>(*it);
+        if (hub != nullptr && !hub->isPrecisionReached())
+            return false;
+        if (!allHubsReachedPrecision(*it))
+            return false;
+    }
+    return true;
+}
 
-        // Logic for data transmission based on Kalman Filter output
-        double predictionError = std::abs(filteredValue - receivedValue);
-        predictionErrors.push_back(predictionError);
-        predictionErrorVector.record(predictionError);
+void HubNode::checkPrecision()
+{
+    long truncationBatch = steadyState.getTruncationBatch();
+    double mean = steadyState.getSteadyStateMean(truncationBatch);
+    double halfWidth = steadyState.getConfidenceHalfWidth(truncationBatch);
+    if (halfWidth < 0 || mean == 0 || halfWidth / std::abs(mean) > targetRelativePrecision)
+        return;
+
+    precisionReached = true;
+    EV << getClassName() << " " << getName() << " reached the target precision: mean prediction error "
+       << mean << " +/- " << halfWidth << " after " << predictionErrorHistogram.getCount() << " samples\n";
+
+    // The run is statistically complete once every hub has converged
+    if (allHubsReachedPrecision(getSimulation()->getSystemModule())) {
+        EV << "All hubs reached the target precision, ending the simulation\n";
+        endSimulation();
+    }
+}
 
-        if (predictionError == 0 || std::abs(predictionError) == 10) {
-            transmitData = true;
-            EV << "Data transmitted from " << msg->getSenderModule()->getName() << " to OBN node.\n";
-        } else {
-            EV << "Data not transmitted from " << msg->getSenderModule()->getName() << " to OBN node.\n";
-        }
+void HubNode::forwardToObn(cMessage *msg, int sourceId, double receivedValue)
+{
+    // The OBN tells the samples suppressed here from lost ones by this count
+    numSamplesForwarded++;
+    long suppressed = suppressedBySource[sourceId];
+    SensorSample *sample = dynamic_cast<SensorSample *>(msg);
+    if (aggregationSize <= 1) {
+        if (sample != nullptr)
+            sample->setSuppressed(suppressed);
+        numPacketsToObn++;
+        sendReliable(check_and_cast<cPacket *>(msg), 2); // Assuming output_gate[2] is the gate connected to OBN_node
+        return;
+    }
 
-        if (transmitData) {
-            // Forward the message to OBN_node
-            send(msg, "output_gate", 2); // Assuming output_gate[2] is the gate connected to OBN_node
-        }
+    // Pack the sample into the pending batch; the first sample of a batch
+    // starts the latency timer so that no sample waits longer than aggregationMaxLatency
+    if (pendingBatch == nullptr) {
+        pendingBatch = new SampleBatch("batch");
+        scheduleAt(simTime() + aggregationMaxLatency, flushBatchMsg);
     }
+    if (sample != nullptr)
+        pendingBatch->addSample(sourceId, receivedValue, sample->getSeq(), sample->getGenerationTime(), suppressed);
+    else
+        pendingBatch->addSample(sourceId, receivedValue);
+    delete msg;
+
+    if (pendingBatch->getNumSamples() >= aggregationSize)
+        flushBatch();
 }
 
-void Hub_node2::transmitMessage()
+void HubNode::flushBatch()
 {
-    // Create and send the message
-    cMessage *msg1 = new cMessage("Hello There!");
-    int gateIndex = intuniform(0, gateSize("output_gate") - 1);
-    EV << "Hub_node2 " << nodeId << " transmitting message: " << msg1->getName() << " on gate " << gateIndex << "\n";
-    send(msg1, "output_gate", gateIndex);
+    if (flushBatchMsg->isScheduled())
+        cancelEvent(flushBatchMsg);
+    if (pendingBatch == nullptr)
+        return;
+
+    char msgname[32];
+    sprintf(msgname, "batch-%d", pendingBatch->getNumSamples());
+    pendingBatch->setName(msgname);
+    pendingBatch->setByteLength(par("batchHeaderLength").intValue() + pendingBatch->getNumSamples() * par("batchSampleLength").intValue());
+    EV << getClassName() << " " << nodeId << " sending " << msgname << " to OBN node.\n";
+    numPacketsToObn++;
+    sendReliable(pendingBatch, 2);
+    pendingBatch = nullptr;
 }
 
-void Hub_node2::backoff()
+void HubNode::transmitMessage()
 {
-    // Simple backoff mechanism (you can replace this with CSMA/CA or other algorithms)
-    // For simplicity, just wait for a random time within a range
-    double backoffTime = uniform(0, 0.1); // Adjust the range as needed
-    EV << "Hub_node2 " << nodeId << " backing off for " << backoffTime << "s\n";
-    wait(backoffTime);
+    // Create and send the message
+    cPacket *msg1 = new cPacket("Hello There!");
+    msg1->setByteLength(par("controlPacketLength").intValue());
+    int gateIndex = rng.intuniform(0, gateSize("output_gate") - 1);
+    EV << getClassName() << " " << nodeId << " transmitting message: " << msg1->getName() << " on gate " << gateIndex << "\n";
+    sendAccounted(msg1, gateIndex, TxQueue::CONTROL);
 }
 
-void Hub_node2::finish()
+void HubNode::handleCommand(Command *command)
 {
-    // At the end of the simulation, calculate statistics on the collected data
-    // For example, mean, standard deviation, etc.
-    double sum = std::accumulate(predictionErrors.begin(), predictionErrors.end(), 0.0);
-    double mean = sum / predictionErrors.size();
+    if (command->getDestination() != address) {
+        int gateIndex = routes.lookup(command->getDestination());
+        if (gateIndex < 0) {
+            EV << getClassName() << " " << nodeId << " has no route for " << command->getName() << ", dropping it\n";
+            numCommandsUnroutable++;
+            delete command;
+            return;
+        }
+        numCommandsRelayed++;
+        sendAccounted(command, gateIndex, TxQueue::CONTROL);
+        return;
+    }
 
-    EV << "Mean Prediction Error: " << mean << endl;
+    simtime_t latency = simTime() - command->getCreationTime();
+    numCommandsReceived++;
+    commandLatencySum += SIMTIME_DBL(latency);
+    if (commandLatencyVector == nullptr)
+        commandLatencyVector = new cOutVector("commandLatency");
+    commandLatencyVector->record(latency);
+
+    EV << getClassName() << " " << nodeId << " executing " << command->getName() << "\n";
+    if (command->getType() == Command::SET_PROCESS_NOISE)
+        setProcessNoise(command->getValue());
+    delete command;
+}
 
-    // Plotting the data using built-in OMNeT++ capabilities
-    // Make sure to enable result recording in the ini file with "record-eventlog = true"
-    EV << "Plotting Prediction Error data...\n";
-    cHistogram hist("Prediction Error");
-    // hist.setRangeAutoUpper(0); // Remove this line as it's causing an error
-    for (double error : predictionErrors) {
-        hist.collect(error);
+void HubNode::startSuperframe()
+{
+    asleep = false;
+    energy.setState(EnergyModel::IDLE, SIMTIME_DBL(simTime()));
+    checkBattery();
+    if (batteryDepleted)
+        return;
+    numSuperframes++;
+
+    // Beacon to every sensor; output_gate[2] leads to the OBN, which stays awake
+    for (int i = 0; i < gateSize("output_gate"); i++) {
+        if (i == 2)
+            continue;
+        Beacon *beacon = new Beacon("beacon", simTime(), superframeInterval, activePeriod);
+        beacon->setByteLength(par("controlPacketLength").intValue());
+        sendAccounted(beacon, i, TxQueue::CONTROL);
     }
-    hist.recordAs("PredictionError");
+    scheduleAt(simTime() + activePeriod, superframeMsg);
 }
-//Hub_node3:
-
-class Hub_node3 : public cSimpleModule {
-protected:
-    virtual void initialize() override;
-    virtual void handleMessage(cMessage *msg) override;
-    virtual void transmitMessage();
-    virtual void backoff();
-    virtual void finish() override; // Added for data collection and plotting
 
-    // Existing variables
-    int nodeId;
-    double slotDuration = 0.01;
-    bool channelBusy = false;
-
-    // New variables for data collection and plotting
-    std::vector<double> predictionErrors;
-    cOutVector predictionErrorVector;
-
-    // Kalman filter for Node_31 and Node_32 inputs
-    SimpleKalmanFilter kf_node31;
-    SimpleKalmanFilter kf_node32;
+void HubNode::endActivePeriod()
+{
+    // Samples do not wait in a batch across the sleep; packets already
+    // handed to the radio still go out before it switches off
+    if (pendingBatch != nullptr)
+        flushBatch();
+    asleep = true;
+    energy.setState(EnergyModel::SLEEP, SIMTIME_DBL(simTime()));
+    checkBattery();
+    scheduleAt(simTime() + superframeInterval - activePeriod, superframeMsg);
+}
 
-public:
-    Hub_node3() : nodeId(0), kf_node31(0.01, 0.01, 0.01), kf_node32(0.5, 0.5, 0.01) {} // Default constructor
-    cMessage *decrementXMsg = nullptr; // Pointer for the self-message
-    double decrementInterval = 0.0005; // Interval in seconds to decrement x
-    double decrementAmount = 0.3; // Amount to decrement x by each interval
-};
+void HubNode::sendReliable(cPacket *pkt, int gateIndex)
+{
+    if (!arq) {
+        sendAccounted(pkt, gateIndex);
+        return;
+    }
+    ArqFrame *frame = arqSender->submit(pkt, arqHeaderLength, gateIndex, SIMTIME_DBL(simTime()));
+    if (frame == nullptr) {
+        EV << getClassName() << " " << nodeId << " retransmission buffer full, dropping packet\n";
+        return;
+    }
+    sendAccounted(frame, gateIndex);
+    scheduleArqTimer();
+}
 
-Define_Module(Hub_node3);
+cPacket *HubNode::receiveFrame(ArqFrame *frame, cModule *sender)
+{
+    if (frame->hasBitError()) {
+        // Corrupted frames are not acknowledged; the sender retransmits
+        numCorruptedFrames++;
+        delete frame;
+        return nullptr;
+    }
 
-void Hub_node3::initialize() {
-    nodeId = atoi(getName());
-    EV << "Hub_node3 " << nodeId << " initialized\n";
+    // Every intact frame is acknowledged, duplicates too, as their first ACK may have been lost
+    int gateIndex = routes.lookup(sender->par("nodeId").intValue());
+    if (gateIndex >= 0) {
+        ArqAck *ack = new ArqAck("ack", frame->getSeq());
+        ack->setByteLength(par("controlPacketLength").intValue());
+        sendAccounted(ack, gateIndex, TxQueue::CONTROL);
+    }
 
-    // Initialize x from a parameter
-    if (nodeId == 0) {
-        char msgname[20];
-        sprintf(msgname, "Hello-%d", nodeId);
-        cMessage *msg = new cMessage(msgname);
-        scheduleAt(0.0, msg);
+    if (!arqReceivers[sender->getId()].accept(frame)) {
+        numDuplicateFrames++;
+        delete frame;
+        return nullptr;
     }
-    decrementXMsg = new cMessage("decrementX");
-    scheduleAt(simTime() + decrementInterval, decrementXMsg);
+    cPacket *pkt = frame->decapsulate();
+    delete frame;
+    return pkt;
+}
 
-    // Registering the vector for data collection
-    predictionErrorVector.setName("PredictionError");
+void HubNode::handleAck(ArqAck *ack)
+{
+    if (ack->hasBitError() || !arq)
+        EV << getClassName() << " " << nodeId << " ignoring " << (ack->hasBitError() ? "corrupted" : "unexpected") << " ACK\n";
+    else
+        arqSender->acknowledge(ack->getSeq(), SIMTIME_DBL(simTime()));
+    delete ack;
 }
 
-void Hub_node3::handleMessage(cMessage *msg)
+void HubNode::retransmitExpired()
 {
-    // Check if the message received is "Hello There!"
-    if (strcmp(msg->getSenderModule()->getName(), "OBN") == 0) {
-        EV << "Received 'Hello There!' message from the OBN. Starting message transmission.\n";
-        // Start transmitting messages
-        transmitMessage();
-    } else {
-        // Handle other messages here
-        EV << "Hub_node3 " << getName() << " received a message, but waiting for 'Hello There!' from the OBN.\n";
-        // Store the received message and handle it later
-        // Example: storeMessage(msg);
+    if (asleep) {
+        // The radio is off; retransmit at the start of the next superframe
+        scheduleAt(superframeMsg->getArrivalTime(), arqTimerMsg);
+        return;
     }
+    std::vector<ArqSender::Retransmission> retransmissions;
+    arqSender->collectExpired(SIMTIME_DBL(simTime()), retransmissions);
+    for (const ArqSender::Retransmission& retransmission : retransmissions)
+        sendAccounted(retransmission.frame, retransmission.gateIndex);
+    scheduleArqTimer();
+}
 
-    if (msg == decrementXMsg) {
-        // No need to cancel the event here since we're within its handling code, and it's automatically unscheduled
-        scheduleAt(simTime() + decrementInterval, decrementXMsg);
-    } else {
-        // Handle other messages
-        double receivedValue = atof(msg->getName());
-        double filteredValue;
-        bool transmitData = false;
-
-        // Perform Kalman filtering on the input
-        if (strcmp(msg->getSenderModule()->getName(), "Node_31") == 0) {
-            // Filter input from Node_31
-            filteredValue = kf_node31.updateEstimate(static_cast<int>(receivedValue));
-            EV << "Received value from Node_31: " << receivedValue << ", Predicted value: " << filteredValue << endl;
-            EV << "Node 31 data received at Hub_3.\n";
-        } else if (strcmp(msg->getSenderModule()->getName(), "Node_32") == 0) {
-            // Filter input from Node_32
-            filteredValue = kf_node32.updateEstimate(static_cast<int>(receivedValue));
-            EV << "Received value from Node_32: " << receivedValue << ", Predicted value: " << filteredValue << endl;
-            EV << "Node 32 data received at Hub_3.\n";
-        } else {
-            // Handle other messages here
-            EV << "Received a message from unexpected sender: " << msg->getSenderModule()->getName() << ".\n";
-            // Handle the message according to your application logic
-        }
-
-        // Logic for data transmission based on Kalman Filter output
-        double predictionError = std::abs(filteredValue - receivedValue);
-        predictionErrors.push_back(predictionError);
-        predictionErrorVector.record(predictionError);
+void HubNode::scheduleArqTimer()
+{
+    // One timer for all outstanding frames; it is moved only when it fires
+    // or when nothing was outstanding before
+    if (arqTimerMsg->isScheduled())
+        return;
+    double deadline = arqSender->getNextDeadline();
+    if (deadline >= 0)
+        scheduleAt(std::max(simTime(), SimTime(deadline)), arqTimerMsg);
+}
 
-        if (predictionError == 0 || std::abs(predictionError) == 10) {
-            transmitData = true;
-            EV << "Data transmitted from " << msg->getSenderModule()->getName() << " to OBN node.\n";
-        } else {
-            EV << "Data not transmitted from " << msg->getSenderModule()->getName() << " to OBN node.\n";
-        }
+void HubNode::sendAccounted(cMessage *msg, int gateIndex, TxQueue::Priority priority)
+{
+    if (batteryDepleted) {
+        delete msg;
+        return;
+    }
+    cPacket *pkt = check_and_cast<cPacket *>(msg);
+    if (txQueue == nullptr) {
+        transmit(pkt, gateIndex);
+        return;
+    }
+    // A full link queue drops the new packet or displaces a lower priority one
+    delete txQueue->enqueue(pkt, gateIndex, priority, SIMTIME_DBL(simTime()));
+    if (!txQueue->isBusy())
+        startTransmission();
+}
 
-        if (transmitData) {
-            // Forward the message to OBN_node
-            send(msg, "output_gate", 2); // Assuming output_gate[2] is the gate connected to OBN_node
-        }
+void HubNode::startTransmission()
+{
+    int gateIndex;
+    cPacket *pkt = txQueue->dequeue(gateIndex, SIMTIME_DBL(simTime()));
+    if (pkt == nullptr)
+        return;
+    if (batteryDepleted) {
+        delete pkt;
+        return;
     }
+    // The radio is busy for the packet's airtime
+    txQueue->setBusy(true);
+    scheduleAt(simTime() + energy.getAirtime(pkt->getBitLength()), txDoneMsg);
+    transmit(pkt, gateIndex);
 }
 
-void Hub_node3::transmitMessage()
+void HubNode::transmit(cPacket *pkt, int gateIndex)
 {
-    // Create and send the message
-    cMessage *msg1 = new cMessage("Hello There!");
-    int gateIndex = intuniform(0, gateSize("output_gate") - 1);
-    EV << "Hub_node3 " << nodeId << " transmitting message: " << msg1->getName() << " on gate " << gateIndex << "\n";
-    send(msg1, "output_gate", gateIndex);
+    energy.chargeTx(pkt->getBitLength(), SIMTIME_DBL(simTime()));
+    checkBattery();
+    if (medium != nullptr)
+        medium->transmit(this, pkt, gateIndex, energy.getAirtime(pkt->getBitLength()));
+    send(pkt, "output_gate", gateIndex);
+}
+
+void HubNode::checkBattery()
+{
+    if (batteryDepleted || !energy.isDepleted())
+        return;
+    batteryDepleted = true;
+    EV << getClassName() << " " << nodeId << " battery depleted at t=" << energy.getDepletionTime() << "s\n";
+    bubble("Battery depleted!");
 }
 
-void Hub_node3::backoff()
+void HubNode::backoff()
 {
     // Simple backoff mechanism (you can replace this with CSMA/CA or other algorithms)
     // For simplicity, just wait for a random time within a range
-    double backoffTime = uniform(0, 0.1); // Adjust the range as needed
-    EV << "Hub_node3 " << nodeId << " backing off for " << backoffTime << "s\n";
+    double backoffTime = rng.uniform(0, 0.1); // Adjust the range as needed
+    EV << getClassName() << " " << nodeId << " backing off for " << backoffTime << "s\n";
     wait(backoffTime);
 }
 
-void Hub_node3::finish()
+void HubNode::saveState(CheckpointWriter& writer)
 {
+    writer.putDoubles(predictionErrorLog != nullptr ? *predictionErrorLog : std::vector<double>());
+    writer.putLong(numSamplesFiltered);
+    writer.putLong(numWarmupSamples);
+    steadyState.saveState(writer);
+    writer.putBool(precisionReached);
+    writer.putLong(numSamplesForwarded);
+    writer.putLong(numPacketsToObn);
+    writer.putInt(static_cast<int>(suppressedBySource.size()));
+    for (const auto& entry : suppressedBySource) {
+        writer.putInt(entry.first);
+        writer.putLong(entry.second);
+    }
+    energy.saveState(writer, SIMTIME_DBL(simTime()));
+    writer.putBool(batteryDepleted);
+    rng.saveState(writer);
+    // The optional parts are written only when enabled, so a checkpoint must be restored with the same configuration
+    if (txQueue != nullptr)
+        txQueue->saveState(writer, SIMTIME_DBL(simTime()));
+    writer.putLong(numCommandsReceived);
+    writer.putLong(numCommandsRelayed);
+    writer.putLong(numCommandsUnroutable);
+    writer.putDouble(commandLatencySum);
+    if (arqSender != nullptr)
+        arqSender->saveState(writer);
+    writer.putInt(static_cast<int>(arqReceivers.size()));
+    for (const auto& entry : arqReceivers) {
+        writer.putInt(entry.first);
+        entry.second.saveState(writer);
+    }
+    writer.putLong(numCorruptedFrames);
+    writer.putLong(numDuplicateFrames);
+    writer.putDouble(CheckpointManager::remainingTime(decrementXMsg));
+    writer.putDouble(CheckpointManager::remainingTime(flushBatchMsg));
+    writer.putInt(pendingBatch ? pendingBatch->getNumSamples() : -1);
+    if (pendingBatch != nullptr) {
+        for (const Sample& sample : pendingBatch->getSamples()) {
+            writer.putInt(sample.sourceId);
+            writer.putDouble(sample.value);
+            writer.putLong(sample.seq);
+            writer.putDouble(SIMTIME_DBL(sample.generationTime - simTime())); // Relative, as the restored run starts at t=0
+            writer.putLong(sample.suppressed);
+        }
+    }
+    if (dutyCycling) {
+        writer.putBool(asleep);
+        writer.putLong(numSuperframes);
+        writer.putLong(numPacketsMissedAsleep);
+        writer.putDouble(CheckpointManager::remainingTime(superframeMsg));
+    }
+    filters.saveState(writer);
+}
+
+void HubNode::loadState(CheckpointReader& reader)
+{
+    // Replayed in their original order, so the histogram is the same as without the checkpoint
+    std::vector<double> predictionErrors = reader.getDoubles();
+    for (double error : predictionErrors)
+        predictionErrorHistogram.collect(error);
+    if (predictionErrorLog != nullptr)
+        predictionErrorLog->swap(predictionErrors);
+    numSamplesFiltered = reader.getLong();
+    numWarmupSamples = reader.getLong();
+    steadyState.loadState(reader);
+    precisionReached = reader.getBool();
+    numSamplesForwarded = reader.getLong();
+    numPacketsToObn = reader.getLong();
+    int numSources = reader.getInt();
+    for (int i = 0; i < numSources; i++) {
+        int sourceId = reader.getInt();
+        suppressedBySource[sourceId] = reader.getLong();
+    }
+    energy.loadState(reader, SIMTIME_DBL(simTime()));
+    batteryDepleted = reader.getBool();
+    rng.loadState(reader);
+    if (txQueue != nullptr)
+        txQueue->loadState(reader, SIMTIME_DBL(simTime()));
+    numCommandsReceived = reader.getLong();
+    numCommandsRelayed = reader.getLong();
+    numCommandsUnroutable = reader.getLong();
+    commandLatencySum = reader.getDouble();
+    if (arqSender != nullptr)
+        arqSender->loadState(reader);
+    int numReceivers = reader.getInt();
+    for (int i = 0; i < numReceivers; i++) {
+        int senderId = reader.getInt();
+        arqReceivers[senderId].loadState(reader);
+    }
+    numCorruptedFrames = reader.getLong();
+    numDuplicateFrames = reader.getLong();
+
+    double remaining = reader.getDouble();
+    if (decrementXMsg != nullptr && decrementXMsg->isScheduled())
+        cancelEvent(decrementXMsg);
+    if (decrementXMsg != nullptr && remaining >= 0)
+        scheduleAt(simTime() + remaining, decrementXMsg);
+
+    remaining = reader.getDouble();
+    if (remaining >= 0) {
+        if (flushBatchMsg == nullptr)
+            throw cRuntimeError("Checkpoint has a pending batch but aggregation is disabled");
+        scheduleAt(simTime() + remaining, flushBatchMsg);
+    }
+
+    // Module ids are assigned in the same order as in the original run, so
+    // the source ids of the pending samples are still valid
+    int numPending = reader.getInt();
+    if (numPending >= 0) {
+        pendingBatch = new SampleBatch("batch");
+        for (int i = 0; i < numPending; i++) {
+            int sourceId = reader.getInt();
+            double value = reader.getDouble();
+            long seq = reader.getLong();
+            simtime_t generationTime = simTime() + reader.getDouble();
+            pendingBatch->addSample(sourceId, value, seq, generationTime, reader.getLong());
+        }
+    }
+    if (dutyCycling) {
+        asleep = reader.getBool();
+        numSuperframes = reader.getLong();
+        numPacketsMissedAsleep = reader.getLong();
+        remaining = reader.getDouble();
+        if (remaining >= 0)
+            scheduleAt(simTime() + remaining, superframeMsg);
+    }
+    filters.loadState(reader);
+}
+
+void HubNode::finish()
+{
+    // Samples still waiting in a batch never reach the OBN
+    if (pendingBatch != nullptr)
+        EV << pendingBatch->getNumSamples() << " aggregated samples still pending at end of simulation\n";
+
     // At the end of the simulation, calculate statistics on the collected data
     // For example, mean, standard deviation, etc.
-    double sum = std::accumulate(predictionErrors.begin(), predictionErrors.end(), 0.0);
-    double mean = sum / predictionErrors.size();
+    double mean = predictionErrorHistogram.getCount() > 0 ? predictionErrorHistogram.getMean() : NAN;
 
     EV << "Mean Prediction Error: " << mean << endl;
 
     // Plotting the data using built-in OMNeT++ capabilities
     // Make sure to enable result recording in the ini file with "record-eventlog = true"
     EV << "Plotting Prediction Error data...\n";
-    cHistogram hist("Prediction Error");
-    // hist.setRangeAutoUpper(0); // Remove this line as it's causing an error
-    for (double error : predictionErrors) {
-        hist.collect(error);
+    predictionErrorHistogram.recordAs("PredictionError");
+
+    recordScalar("warmupSamplesDiscarded", numWarmupSamples);
+    long truncationBatch = steadyState.getTruncationBatch();
+    recordScalar("mserTruncationPoint", steadyState.getTruncationPoint(truncationBatch));
+    recordScalar("steadyStatePredictionError", steadyState.getSteadyStateMean(truncationBatch));
+    double halfWidth = steadyState.getConfidenceHalfWidth(truncationBatch);
+    if (halfWidth >= 0)
+        recordScalar("steadyStatePredictionErrorCI", halfWidth);
+    recordScalar("precisionReached", precisionReached);
+
+    recordScalar("samplesForwarded", numSamplesForwarded);
+    recordScalar("packetsToObn", numPacketsToObn);
+    energy.recordScalars(this, SIMTIME_DBL(simTime()));
+    if (txQueue != nullptr)
+        txQueue->recordScalars(this, SIMTIME_DBL(simTime()));
+    if (arqSender != nullptr) {
+        arqSender->recordScalars(this);
+        recordScalar("arqCorruptedFrames", numCorruptedFrames);
+        recordScalar("arqDuplicateFrames", numDuplicateFrames);
+    }
+    if (dutyCycling) {
+        recordScalar("superframes", numSuperframes);
+        recordScalar("packetsMissedAsleep", numPacketsMissedAsleep);
+    }
+    if (numCommandsReceived + numCommandsRelayed + numCommandsUnroutable > 0) {
+        recordScalar("commandsReceived", numCommandsReceived);
+        recordScalar("commandsRelayed", numCommandsRelayed);
+        recordScalar("commandsUnroutable", numCommandsUnroutable);
+        recordScalar("commandLatency:mean", numCommandsReceived ? commandLatencySum / numCommandsReceived : 0, "s");
     }
-    hist.recordAs("PredictionError");
 }
+
+// Hub_node1, Hub_node2 and Hub_node3 only select their entry of the hub filter configuration
+
+class Hub_node1 : public HubNode {
+public:
+    Hub_node1() : HubNode(0) {} // Kalman filters for Node_11 and Node_12 inputs
+};
+
+Define_Module(Hub_node1);
+
+class Hub_node2 : public HubNode {
+public:
+    Hub_node2() : HubNode(1) {} // Kalman filters for Node_21 and Node_22 inputs
+};
+
+Define_Module(Hub_node2);
+
+class Hub_node3 : public HubNode {
+public:
+    Hub_node3() : HubNode(2) {} // Kalman filters for Node_31 and Node_32 inputs
+};
+
+Define_Module(Hub_node3);
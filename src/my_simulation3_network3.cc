@@ -7,438 +7,716 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
+#include <cmath>
 #include <omnetpp.h>
+#include "EnergyModel.h"
+#include "CheckpointManager.h"
+#include "PhiloxRng.h"
+#include "Command.h"
+#include "TxQueue.h"
+#include "Arq.h"
+#include "SampleBatch.h"
+#include "SignalModel.h"
+#include "MemoryMonitor.h"
+#include "SharedMedium.h"
+#include "Beacon.h"
 
 using namespace omnetpp;
 
-class node11 : public cSimpleModule
+// Common behaviour of the sensor nodes node11 ... node32. The sensors only
+// differ in the range of the values they generate and in their log labels.
+class SensorNode : public cSimpleModule, public Checkpointable, public MemoryAccountable
 {
 protected:
     virtual void initialize() override;
     virtual void handleMessage(cMessage *msg) override;
     virtual void transmitMessage();
-
+    virtual void transmitSample(simtime_t generationTime);
+    // Next value of the signal model, saturated at the sensor's range
+    virtual int nextSignalValue();
+    virtual void finish() override;
+    virtual void checkBattery();
+
+    // Sends on the given output gate and charges the transmission to the
+    // battery; with txQueueing the packet waits for the radio in txQueue
+    virtual void sendAccounted(cMessage *msg, int gateIndex, TxQueue::Priority priority = TxQueue::DATA);
+    virtual void startTransmission();
+    virtual void transmit(cPacket *pkt, int gateIndex);
+
+    // ARQ towards the hub: samples go through arqSender, one timer for all outstanding frames
+    virtual void sendReliable(cPacket *pkt, int gateIndex);
+    virtual void retransmitExpired();
+    virtual void scheduleArqTimer();
+
+    // Downlink commands from the OBN
+    virtual void handleCommand(Command *command);
+    virtual void setSampleInterval(simtime_t interval);
+    virtual void sleep(simtime_t duration);
+    virtual void wakeUp();
+
+    // Duty cycling on the schedule of the hub's beacons
+    virtual void handleBeacon(Beacon *beacon);
+    virtual void handleSuperframe();
+    // Sends the samples that fell due while the node slept
+    virtual void transmitDueSamples();
+
+    // Checkpointable
+    virtual void saveState(CheckpointWriter& writer) override;
+    virtual void loadState(CheckpointReader& reader) override;
+    virtual bool hasPendingPackets() const override;
+
+    // MemoryAccountable
+    virtual size_t getMemoryFootprint() const override;
+
+    bool isAsleep() const { return wakeMsg != nullptr && wakeMsg->isScheduled(); }
+    // Moving average of the last WINDOW_SIZE values
+    double getPredictedNumber() const { return windowCount > 0 ? static_cast<double>(windowSum) / windowCount : 0; }
+
+    // Hot state, used for every sample
+    static const int WINDOW_SIZE = 5;
+    int window[WINDOW_SIZE];  // Ring buffer of the last values
+    int windowPos = 0;        // Oldest value once the window is full
+    int windowCount = 0;
+    long windowSum = 0;
+
+    int maxValue;             // Values lie in [0, maxValue]
     int nodeId;
-    double predictedNumber;
-    std::vector<int> receivedValues;
-    int windowSize = 5;
+    bool batteryDepleted = false;
+    bool arq = false;
+    int signalBlockSize = 1;
+    size_t signalPos = 0;     // Next unused value of signalBlock
+    std::vector<double> signalBlock;
+    SignalModel *signal = nullptr;
+    ModuleRng rng;            // Source of the sample values
+
+    // Sampling: all samples at start-up, or one every sampleInterval
+    int numSamples = 100;
+    long numSamplesSent = 0;
+    simtime_t sampleInterval;
+    cMessage *sampleMsg = nullptr;
+
+    // Energy accounting
+    EnergyModel energy;
+
+    // Cold state: log labels and optional features, allocated only when used
+    const char *label;        // Name used in the log, e.g. "Node11"
+    const char *hubSuffix;    // Appended to the transmission log, e.g. " to Hub_node2"
+
+    // Transmit queue of the radio (nullptr unless txQueueing is set)
+    TxQueue *txQueue = nullptr;
+    cMessage *txDoneMsg = nullptr;
+
+    // Downlink commands; the radio is off while wakeMsg is pending
+    cMessage *wakeMsg = nullptr;
+    long numCommandsReceived = 0;
+    double commandLatencySum = 0;
+    cOutVector *commandLatencyVector = nullptr;
+
+    // Link-layer retransmissions (nullptr unless arq is set)
+    int arqHeaderLength = 0;
+    ArqSender *arqSender = nullptr;
+    cMessage *arqTimerMsg = nullptr;
+
+    // Interference with the other transmissions (nullptr = private links)
+    SharedMedium *medium = nullptr;
+
+    // Duty cycling: the node listens until the first beacon of its hub, then
+    // is awake only during the hub's active periods (cycleAsleep in between).
+    // Sampling has no timer; the samples due since the last wake-up are
+    // generated and sent together, stamped with their due times.
+    bool dutyCycling = false;
+    bool cycleAsleep = false;
+    simtime_t superframeInterval;
+    simtime_t activePeriod;
+    simtime_t nextSampleTime;
+    cMessage *superframeMsg = nullptr;
+    long numBeaconsReceived = 0;
+    long numPacketsMissedAsleep = 0;
 
 public:
-    node11(int id = 0) : nodeId(id), predictedNumber(0) {}
+    SensorNode(const char *label, int maxValue, const char *hubSuffix)
+        : maxValue(maxValue), nodeId(0), label(label), hubSuffix(hubSuffix) {}
+    virtual ~SensorNode();
 };
 
-Define_Module(node11);
-
-void node11::initialize()
+SensorNode::~SensorNode()
 {
-    // Get the nodeId parameter from the parent module
-    nodeId = par("nodeId");
-
-    // Initialize the node
-    EV << "Node11 " << nodeId << " initialized\n";
-
-    // Start transmitting messages
-    transmitMessage();
+    cancelAndDelete(sampleMsg);
+    cancelAndDelete(txDoneMsg);
+    cancelAndDelete(wakeMsg);
+    cancelAndDelete(arqTimerMsg);
+    cancelAndDelete(superframeMsg);
+    delete signal;
+    delete txQueue;
+    delete arqSender;
+    delete commandLatencyVector;
 }
 
-void node11::handleMessage(cMessage *msg)
+bool SensorNode::hasPendingPackets() const
 {
-    // Handle incoming messages
-    EV << "Node11 " << nodeId << " received a message: " << msg->getName() << "\n";
-
-    // Delete the message after processing
-    delete msg;
+    return (txQueue != nullptr && (txQueue->isBusy() || !txQueue->isEmpty())) || (arqSender != nullptr && !arqSender->isEmpty());
 }
 
-void node11::transmitMessage()
+size_t SensorNode::getMemoryFootprint() const
 {
-    for (int i = 0; i < 100; ++i) {
-        // Generate random input values within the specified range
-        int randomValue = intuniform(0, 220);
-        receivedValues.push_back(randomValue);
-
-        // Keep the window size limited
-        if (receivedValues.size() > windowSize) {
-            receivedValues.erase(receivedValues.begin());
-        }
-
-        // Calculate the predicted number using moving average
-        double sum = 0;
-        for (int value : receivedValues) {
-            sum += value;
-        }
-        predictedNumber = sum / receivedValues.size();
-
-        // Create and send the message to the hub node
-        char msgname[20];
-        sprintf(msgname, "%d", randomValue);
-        cMessage *msg = new cMessage(msgname);
-
-        // Log message transmission
-        EV << "Node11 " << nodeId << " generating value: " << randomValue << "\n";
-        EV << "Node11 " << nodeId << " transmitting message: " << msg->getName() << "\n";
-
-        send(msg, "output_gate", 0);
-    }
+    size_t bytes = sizeof(*this) + heapBytes(signalBlock);
+    if (signal != nullptr)
+        bytes += sizeof(*signal);
+    if (txQueue != nullptr)
+        bytes += sizeof(TxQueue);
+    if (arqSender != nullptr)
+        bytes += sizeof(ArqSender);
+    if (commandLatencyVector != nullptr)
+        bytes += sizeof(cOutVector);
+    return bytes;
 }
 
-class node12 : public cSimpleModule
-{
-protected:
-    virtual void initialize() override;
-    virtual void handleMessage(cMessage *msg) override;
-    virtual void transmitMessage();
-
-    int nodeId;
-    double predictedNumber;
-    std::vector<int> receivedValues;
-    int windowSize = 5;
-
-public:
-    node12(int id = 0) : nodeId(id), predictedNumber(0) {}
-};
-
-Define_Module(node12);
-
-void node12::initialize()
+void SensorNode::initialize()
 {
     // Get the nodeId parameter from the parent module
-        nodeId = par("nodeId");
+    nodeId = par("nodeId");
+
+    energy.configure(par("supplyVoltage"), par("batteryCapacity"), par("txCurrent"), par("rxCurrent"),
+                     par("idleCurrent"), par("sleepCurrent"), par("radioBitrate"));
+    rng.configure(this, par("perModuleRng"));
+
+    SignalParams signalParams;
+    signalParams.upper = maxValue;
+    double signalMean = par("signalMean");
+    signalParams.mean = signalMean >= 0 ? signalMean : maxValue / 2.0;
+    signalParams.noise = par("signalNoise");
+    signalParams.walkStep = par("walkStep");
+    signalParams.amplitude = par("signalAmplitude");
+    signalParams.period = par("signalPeriod");
+    signalParams.arCoefficients = cStringTokenizer(par("arCoefficients").stringValue()).asDoubleVector();
+    signalParams.jumpProbability = par("jumpProbability");
+    signalParams.burstProbability = par("burstProbability");
+    signalParams.burstLength = par("burstLength");
+    signalParams.burstAmplitude = par("burstAmplitude");
+    try {
+        signal = SignalModel::create(par("signalModel").stdstringValue(), rng.get(), signalParams);
+    } catch (const std::invalid_argument& e) {
+        throw cRuntimeError("%s", e.what());
+    }
+    signalBlockSize = par("signalBlockSize");
+    if (signalBlockSize < 1)
+        throw cRuntimeError("signalBlockSize must be at least 1");
+
+    if (par("txQueueing").boolValue()) {
+        txQueue = new TxQueue();
+        txQueue->configure(gateSize("output_gate"), par("txQueueCapacity"));
+        txDoneMsg = new cMessage("txDone");
+    }
 
+    arq = par("arq");
+    if (arq) {
+        arqSender = new ArqSender();
+        arqSender->configure(par("arqBufferSize"), par("arqTimeout"), par("maxPacketTries"));
+        arqHeaderLength = par("arqHeaderLength");
+        arqTimerMsg = new cMessage("arqTimeout");
+    }
+    medium = SharedMedium::find();
+
+    numSamples = par("numSamples");
+    sampleInterval = par("sampleInterval");
+    dutyCycling = par("dutyCycling");
+    if (dutyCycling) {
+        superframeMsg = new cMessage("superframe");
+        nextSampleTime = simTime() + sampleInterval;
+    } else if (sampleInterval > 0) {
+        sampleMsg = new cMessage("sample");
+    }
 
     // Initialize the node
-    EV << "Node12 " << nodeId << " initialized\n";
+    EV << label << " " << nodeId << " initialized\n";
+
+    // A run resumed from a checkpoint continues from the saved state instead of starting up
+    if (CheckpointManager::restore(this))
+        return;
 
     // Start transmitting messages
-    transmitMessage();
+    if (sampleMsg != nullptr)
+        scheduleAt(simTime() + sampleInterval, sampleMsg);
+    else
+        transmitMessage();
 }
 
-void node12::handleMessage(cMessage *msg)
+void SensorNode::handleMessage(cMessage *msg)
 {
+    if (msg == sampleMsg) {
+        transmitSample(simTime());
+        if (!batteryDepleted && (numSamples < 0 || numSamplesSent < numSamples))
+            scheduleAt(simTime() + sampleInterval, sampleMsg);
+        return;
+    }
+    if (msg == txDoneMsg) {
+        txQueue->setBusy(false);
+        startTransmission();
+        return;
+    }
+    if (msg == wakeMsg) {
+        wakeUp();
+        return;
+    }
+    if (msg == arqTimerMsg) {
+        retransmitExpired();
+        return;
+    }
+    if (msg == superframeMsg) {
+        handleSuperframe();
+        return;
+    }
+
+    if (isAsleep() || cycleAsleep) {
+        // The radio is off while sleeping
+        numPacketsMissedAsleep++;
+        delete msg;
+        return;
+    }
+    if (!batteryDepleted) {
+        cPacket *pkt = dynamic_cast<cPacket *>(msg);
+        energy.chargeRx(pkt ? pkt->getBitLength() : 0, SIMTIME_DBL(simTime()));
+        checkBattery();
+        if (medium != nullptr && pkt != nullptr && !medium->receive(pkt, this) && !dynamic_cast<ArqFrame *>(pkt) && !dynamic_cast<ArqAck *>(pkt)) {
+            // Lost to interference; ARQ frames and ACKs go on with their bit error flag set
+            delete msg;
+            return;
+        }
+    }
+
+    if (Command *command = dynamic_cast<Command *>(msg)) {
+        handleCommand(command);
+        return;
+    }
+    if (Beacon *beacon = dynamic_cast<Beacon *>(msg)) {
+        handleBeacon(beacon);
+        return;
+    }
+    if (ArqAck *ack = dynamic_cast<ArqAck *>(msg)) {
+        if (arq && !ack->hasBitError())
+            arqSender->acknowledge(ack->getSeq(), SIMTIME_DBL(simTime()));
+        delete ack;
+        return;
+    }
+
     // Handle incoming messages
-    EV << "Node12 " << nodeId << " received a message: " << msg->getName() << "\n";
+    EV << label << " " << nodeId << " received a message: " << msg->getName() << "\n";
 
     // Delete the message after processing
     delete msg;
 }
 
-void node12::transmitMessage()
+void SensorNode::transmitMessage()
 {
-    for (int i = 0; i < 100; ++i) {
-        // Generate random input values within the specified range
-        int randomValue = intuniform(0, 220);
-        receivedValues.push_back(randomValue);
-
-        // Keep the window size limited
-        if (receivedValues.size() > windowSize) {
-            receivedValues.erase(receivedValues.begin());
-        }
-
-        // Calculate the predicted number using moving average
-        double sum = 0;
-        for (int value : receivedValues) {
-            sum += value;
-        }
-        predictedNumber = sum / receivedValues.size();
-
-        // Create and send the message to the hub node
-        char msgname[20];
-        sprintf(msgname, "%d", randomValue);
-        cMessage *msg = new cMessage(msgname);
-
-        // Log message transmission
-        EV << "Node12 " << nodeId << " generating value: " << randomValue << "\n";
-        EV << "Node12 " << nodeId << " transmitting message: " << msg->getName() << "\n";
-
-        send(msg, "output_gate", 0);
+    for (int i = 0; i < numSamples; ++i) {
+        if (batteryDepleted)
+            break;
+        transmitSample(simTime());
     }
 }
 
-
-class node21 : public cSimpleModule
+void SensorNode::transmitSample(simtime_t generationTime)
 {
-protected:
-    virtual void initialize() override;
-    virtual void handleMessage(cMessage *msg) override;
-    virtual void transmitMessage();
+    // Generate the next input value within the specified range
+    int randomValue = nextSignalValue();
+
+    // Keep the moving average window up to date; the oldest value drops out once it is full
+    if (windowCount == WINDOW_SIZE) {
+        windowSum -= window[windowPos];
+        window[windowPos] = randomValue;
+        windowPos = (windowPos + 1) % WINDOW_SIZE;
+    } else {
+        window[windowCount++] = randomValue;
+    }
+    windowSum += randomValue;
 
-    int nodeId;
-    double predictedNumber;
-    std::vector<int> receivedValues;
-    int windowSize = 5;
+    // Create and send the message to the hub node
+    char msgname[20];
+    sprintf(msgname, "%d", randomValue);
+    SensorSample *msg = new SensorSample(msgname);
+    msg->setByteLength(par("dataPacketLength").intValue());
+    msg->setSource(getId(), numSamplesSent, generationTime);
 
-public:
-    node21(int id = 0) : nodeId(id), predictedNumber(0) {}
-};
+    // Log message transmission
+    EV << label << " " << nodeId << " generating value: " << randomValue << "\n";
+    EV << label << " " << nodeId << " transmitting message: " << msg->getName() << hubSuffix << "\n";
 
-Define_Module(node21);
+    numSamplesSent++;
+    sendReliable(msg, 0);
+}
 
-void node21::initialize()
+int SensorNode::nextSignalValue()
 {
-    // Get the nodeId parameter from the parent module
-        nodeId = par("nodeId");
-
-
-    // Initialize the node
-    EV << "Node21 " << nodeId << " initialized\n";
-
-    // Start transmitting messages
-    transmitMessage();
+    if (signalPos == signalBlock.size()) {
+        // No values beyond the last sample are drawn, as the RNG may be shared with other modules
+        long count = signalBlockSize;
+        if (numSamples >= 0)
+            count = std::max(1L, std::min(count, numSamples - numSamplesSent));
+        signalBlock.resize(count);
+        signal->generate(signalBlock.data(), static_cast<int>(count));
+        signalPos = 0;
+    }
+    double value = std::round(signalBlock[signalPos++]);
+    return static_cast<int>(std::min(std::max(value, 0.0), static_cast<double>(maxValue)));
 }
 
-void node21::handleMessage(cMessage *msg)
+void SensorNode::sendReliable(cPacket *pkt, int gateIndex)
 {
-    // Handle incoming messages
-    EV << "Node21 " << nodeId << " received a message: " << msg->getName() << "\n";
-
-    // Delete the message after processing
-    delete msg;
+    if (!arq) {
+        sendAccounted(pkt, gateIndex);
+        return;
+    }
+    ArqFrame *frame = arqSender->submit(pkt, arqHeaderLength, gateIndex, SIMTIME_DBL(simTime()));
+    if (frame == nullptr) {
+        EV << label << " " << nodeId << " retransmission buffer full, dropping sample\n";
+        return;
+    }
+    sendAccounted(frame, gateIndex);
+    scheduleArqTimer();
 }
 
-void node21::transmitMessage()
+void SensorNode::retransmitExpired()
 {
-    for (int i = 0; i < 100; ++i) {
-        // Generate random input values within the specified range
-        int randomValue = intuniform(0, 220);
-        receivedValues.push_back(randomValue);
-
-        // Keep the window size limited
-        if (receivedValues.size() > windowSize) {
-            receivedValues.erase(receivedValues.begin());
-        }
-
-        // Calculate the predicted number using moving average
-        double sum = 0;
-        for (int value : receivedValues) {
-            sum += value;
-        }
-        predictedNumber = sum / receivedValues.size();
-
-        // Create and send the message to Hub_node2
-        char msgname[20];
-        sprintf(msgname, "%d", randomValue);
-        cMessage *msg = new cMessage(msgname);
-
-        // Log message transmission
-        EV << "Node21 " << nodeId << " generating value: " << randomValue << "\n";
-        EV << "Node21 " << nodeId << " transmitting message: " << msg->getName() << " to Hub_node2\n";
-
-        send(msg, "output_gate", 0);
+    if (isAsleep() || cycleAsleep) {
+        // The radio is off; retransmit once the node wakes up
+        scheduleAt(isAsleep() ? wakeMsg->getArrivalTime() : superframeMsg->getArrivalTime(), arqTimerMsg);
+        return;
     }
+    std::vector<ArqSender::Retransmission> retransmissions;
+    arqSender->collectExpired(SIMTIME_DBL(simTime()), retransmissions);
+    for (const ArqSender::Retransmission& retransmission : retransmissions)
+        sendAccounted(retransmission.frame, retransmission.gateIndex);
+    scheduleArqTimer();
 }
 
-class node22 : public cSimpleModule
+void SensorNode::scheduleArqTimer()
 {
-protected:
-    virtual void initialize() override;
-    virtual void handleMessage(cMessage *msg) override;
-    virtual void transmitMessage();
-
-    int nodeId;
-    double predictedNumber;
-    std::vector<int> receivedValues;
-    int windowSize = 5;
-
-public:
-    node22(int id = 0) : nodeId(id), predictedNumber(0) {}
-};
-
-Define_Module(node22);
+    // The timer is moved only when it fires or when nothing was outstanding before
+    if (arqTimerMsg->isScheduled())
+        return;
+    double deadline = arqSender->getNextDeadline();
+    if (deadline >= 0)
+        scheduleAt(std::max(simTime(), SimTime(deadline)), arqTimerMsg);
+}
 
-void node22::initialize()
+void SensorNode::handleCommand(Command *command)
 {
-    // Get the nodeId parameter from the parent module
-        nodeId = par("nodeId");
-
-
-    // Initialize the node
-    EV << "Node22 " << nodeId << " initialized\n";
+    if (command->getDestination() != nodeId) {
+        // Sensors are leaves of the routing tree
+        EV << label << " " << nodeId << " dropping " << command->getName() << " addressed to another node\n";
+        delete command;
+        return;
+    }
 
-    // Start transmitting messages
-    transmitMessage();
+    simtime_t latency = simTime() - command->getCreationTime();
+    numCommandsReceived++;
+    commandLatencySum += SIMTIME_DBL(latency);
+    if (commandLatencyVector == nullptr)
+        commandLatencyVector = new cOutVector("commandLatency");
+    commandLatencyVector->record(latency);
+
+    EV << label << " " << nodeId << " executing " << command->getName() << "\n";
+    switch (command->getType()) {
+        case Command::SET_SAMPLE_INTERVAL: setSampleInterval(command->getValue()); break;
+        case Command::SLEEP: sleep(command->getValue()); break;
+        default: break;
+    }
+    delete command;
 }
 
-void node22::handleMessage(cMessage *msg)
+void SensorNode::setSampleInterval(simtime_t interval)
 {
-    // Handle incoming messages
-    EV << "Node22 " << nodeId << " received a message: " << msg->getName() << "\n";
-
-    // Delete the message after processing
-    delete msg;
+    if (interval <= 0)
+        return;
+    sampleInterval = interval;
+    if (dutyCycling) {
+        // The next sample falls due one interval from now and is sent at a wake-up
+        nextSampleTime = simTime() + sampleInterval;
+        return;
+    }
+    if (sampleMsg == nullptr)
+        sampleMsg = new cMessage("sample");
+    if (isAsleep())
+        return; // Takes effect when the node wakes up
+    if (sampleMsg->isScheduled())
+        cancelEvent(sampleMsg);
+    if (!batteryDepleted && (numSamples < 0 || numSamplesSent < numSamples))
+        scheduleAt(simTime() + sampleInterval, sampleMsg);
 }
 
-void node22::transmitMessage()
+void SensorNode::sleep(simtime_t duration)
 {
-    for (int i = 0; i < 100; ++i) {
-        // Generate random input values within the specified range
-        int randomValue = intuniform(0, 200);
-        receivedValues.push_back(randomValue);
-
-        // Keep the window size limited
-        if (receivedValues.size() > windowSize) {
-            receivedValues.erase(receivedValues.begin());
-        }
-
-        // Calculate the predicted number using moving average
-        double sum = 0;
-        for (int value : receivedValues) {
-            sum += value;
-        }
-        predictedNumber = sum / receivedValues.size();
-
-        // Create and send the message to Hub_node2
-        char msgname[20];
-        sprintf(msgname, "%d", randomValue);
-        cMessage *msg = new cMessage(msgname);
+    if (duration <= 0 || batteryDepleted)
+        return;
+    if (sampleMsg != nullptr && sampleMsg->isScheduled())
+        cancelEvent(sampleMsg);
+    if (wakeMsg == nullptr)
+        wakeMsg = new cMessage("wake");
+    if (wakeMsg->isScheduled())
+        cancelEvent(wakeMsg);
+    energy.setState(EnergyModel::SLEEP, SIMTIME_DBL(simTime()));
+    scheduleAt(simTime() + duration, wakeMsg);
+}
 
-        // Log message transmission
-        EV << "Node22 " << nodeId << " generating value: " << randomValue << "\n";
-        EV << "Node22 " << nodeId << " transmitting message: " << msg->getName() << " to Hub_node2\n";
+void SensorNode::wakeUp()
+{
+    // Within the sleep part of a superframe the radio stays off
+    energy.setState(cycleAsleep ? EnergyModel::SLEEP : EnergyModel::IDLE, SIMTIME_DBL(simTime()));
+    checkBattery();
+    if (dutyCycling)
+        nextSampleTime = simTime() + sampleInterval; // Sampling stopped during the sleep
+    if (sampleMsg != nullptr && !batteryDepleted && (numSamples < 0 || numSamplesSent < numSamples))
+        scheduleAt(simTime() + sampleInterval, sampleMsg);
+}
 
-        send(msg, "output_gate", 0);
+void SensorNode::handleBeacon(Beacon *beacon)
+{
+    if (!dutyCycling || beacon->hasBitError()) {
+        delete beacon;
+        return;
     }
+    // (Re)synchronise with the hub: awake until the end of its active period
+    numBeaconsReceived++;
+    superframeInterval = beacon->getSuperframeInterval();
+    activePeriod = beacon->getActivePeriod();
+    simtime_t activeEnd = beacon->getSuperframeStart() + activePeriod;
+    delete beacon;
+    if (superframeMsg->isScheduled())
+        cancelEvent(superframeMsg);
+    scheduleAt(std::max(simTime(), activeEnd), superframeMsg);
+    if (activeEnd > simTime())
+        transmitDueSamples();
 }
 
-class node31 : public cSimpleModule
+void SensorNode::handleSuperframe()
 {
-protected:
-    virtual void initialize() override;
-    virtual void handleMessage(cMessage *msg) override;
-    virtual void transmitMessage();
-
-    int nodeId;
-    double predictedNumber;
-    std::vector<int> receivedValues;
-    int windowSize = 5;
-
-public:
-    node31(int id = 0) : nodeId(id), predictedNumber(0) {}
-};
-
-Define_Module(node31);
+    if (!cycleAsleep) {
+        // End of the hub's active period
+        cycleAsleep = true;
+        if (!isAsleep())
+            energy.setState(EnergyModel::SLEEP, SIMTIME_DBL(simTime()));
+        scheduleAt(simTime() + superframeInterval - activePeriod, superframeMsg);
+        return;
+    }
+    // Start of the next superframe; the hub wakes up at the same time
+    cycleAsleep = false;
+    scheduleAt(simTime() + activePeriod, superframeMsg);
+    if (isAsleep())
+        return; // Sleeping on a command of the OBN
+    energy.setState(EnergyModel::IDLE, SIMTIME_DBL(simTime()));
+    checkBattery();
+    transmitDueSamples();
+}
 
-void node31::initialize()
+void SensorNode::transmitDueSamples()
 {
-    // Get the nodeId parameter from the parent module
-        nodeId = par("nodeId");
-
-
-    // Initialize the node
-    EV << "Node31 " << nodeId << " initialized\n";
-
-    // Start transmitting messages
-    transmitMessage();
+    if (sampleInterval <= 0)
+        return;
+    while (nextSampleTime <= simTime() && !batteryDepleted && (numSamples < 0 || numSamplesSent < numSamples)) {
+        transmitSample(nextSampleTime);
+        nextSampleTime += sampleInterval;
+    }
 }
 
-void node31::handleMessage(cMessage *msg)
+void SensorNode::sendAccounted(cMessage *msg, int gateIndex, TxQueue::Priority priority)
 {
-    // Handle incoming messages
-    EV << "Node31 " << nodeId << " received a message: " << msg->getName() << "\n";
-
-    // Delete the message after processing
-    delete msg;
+    if (batteryDepleted) {
+        delete msg;
+        return;
+    }
+    cPacket *pkt = check_and_cast<cPacket *>(msg);
+    if (txQueue == nullptr) {
+        transmit(pkt, gateIndex);
+        return;
+    }
+    // A full queue drops the new packet or displaces a lower priority one
+    delete txQueue->enqueue(pkt, gateIndex, priority, SIMTIME_DBL(simTime()));
+    if (!txQueue->isBusy())
+        startTransmission();
 }
 
-void node31::transmitMessage()
+void SensorNode::startTransmission()
 {
-    for (int i = 0; i < 100; ++i) {
-        // Generate random input values within the specified range
-        int randomValue = intuniform(0, 200);
-        receivedValues.push_back(randomValue);
-
-        // Keep the window size limited
-        if (receivedValues.size() > windowSize) {
-            receivedValues.erase(receivedValues.begin());
-        }
-
-        // Calculate the predicted number using moving average
-        double sum = 0;
-        for (int value : receivedValues) {
-            sum += value;
-        }
-        predictedNumber = sum / receivedValues.size();
+    int gateIndex;
+    cPacket *pkt = txQueue->dequeue(gateIndex, SIMTIME_DBL(simTime()));
+    if (pkt == nullptr)
+        return;
+    if (batteryDepleted) {
+        delete pkt;
+        return;
+    }
+    // The radio is busy for the packet's airtime
+    txQueue->setBusy(true);
+    scheduleAt(simTime() + energy.getAirtime(pkt->getBitLength()), txDoneMsg);
+    transmit(pkt, gateIndex);
+}
 
-        // Create and send the message to Hub_node3
-        char msgname[20];
-        sprintf(msgname, "%d", randomValue);
-        cMessage *msg = new cMessage(msgname);
+void SensorNode::transmit(cPacket *pkt, int gateIndex)
+{
+    energy.chargeTx(pkt->getBitLength(), SIMTIME_DBL(simTime()));
+    checkBattery();
+    if (medium != nullptr)
+        medium->transmit(this, pkt, gateIndex, energy.getAirtime(pkt->getBitLength()));
+    send(pkt, "output_gate", gateIndex);
+}
 
-        // Log message transmission
-        EV << "Node31 " << nodeId << " generating value: " << randomValue << "\n";
-        EV << "Node31 " << nodeId << " transmitting message: " << msg->getName() << " to Hub_node3\n";
+void SensorNode::checkBattery()
+{
+    if (batteryDepleted || !energy.isDepleted())
+        return;
+    batteryDepleted = true;
+    EV << label << " " << nodeId << " battery depleted at t=" << energy.getDepletionTime() << "s\n";
+    bubble("Battery depleted!");
+}
 
-        send(msg, "output_gate", 0);
+void SensorNode::saveState(CheckpointWriter& writer)
+{
+    // Window values oldest first
+    std::vector<int> windowValues;
+    for (int i = 0; i < windowCount; i++)
+        windowValues.push_back(window[(windowPos + i) % WINDOW_SIZE]);
+    writer.putInts(windowValues);
+    energy.saveState(writer, SIMTIME_DBL(simTime()));
+    writer.putBool(batteryDepleted);
+    rng.saveState(writer);
+    // The optional parts are written only when enabled, so a checkpoint must be restored with the same configuration
+    if (txQueue != nullptr)
+        txQueue->saveState(writer, SIMTIME_DBL(simTime()));
+    writer.putLong(numCommandsReceived);
+    writer.putDouble(commandLatencySum);
+    if (arqSender != nullptr)
+        arqSender->saveState(writer);
+    writer.putDouble(SIMTIME_DBL(sampleInterval));
+    writer.putDouble(CheckpointManager::remainingTime(wakeMsg));
+    writer.putLong(numSamplesSent);
+    writer.putDouble(CheckpointManager::remainingTime(sampleMsg));
+    signal->saveState(writer);
+    writer.putDoubles(std::vector<double>(signalBlock.begin() + signalPos, signalBlock.end()));
+    if (dutyCycling) {
+        writer.putBool(cycleAsleep);
+        writer.putDouble(SIMTIME_DBL(superframeInterval));
+        writer.putDouble(SIMTIME_DBL(activePeriod));
+        writer.putDouble(CheckpointManager::remainingTime(superframeMsg));
+        writer.putDouble(SIMTIME_DBL(nextSampleTime - simTime()));
+        writer.putLong(numBeaconsReceived);
+        writer.putLong(numPacketsMissedAsleep);
     }
 }
 
-class node32 : public cSimpleModule
+void SensorNode::loadState(CheckpointReader& reader)
 {
-protected:
-    virtual void initialize() override;
-    virtual void handleMessage(cMessage *msg) override;
-    virtual void transmitMessage();
+    std::vector<int> windowValues = reader.getInts();
+    if (windowValues.size() > WINDOW_SIZE)
+        throw cRuntimeError("Checkpoint has %d window values, expected at most %d", (int)windowValues.size(), WINDOW_SIZE);
+    windowCount = static_cast<int>(windowValues.size());
+    windowPos = 0;
+    windowSum = 0;
+    for (int i = 0; i < windowCount; i++) {
+        window[i] = windowValues[i];
+        windowSum += windowValues[i];
+    }
+    energy.loadState(reader, SIMTIME_DBL(simTime()));
+    batteryDepleted = reader.getBool();
+    rng.loadState(reader);
+    if (txQueue != nullptr)
+        txQueue->loadState(reader, SIMTIME_DBL(simTime()));
+    numCommandsReceived = reader.getLong();
+    commandLatencySum = reader.getDouble();
+    if (arqSender != nullptr)
+        arqSender->loadState(reader);
+    sampleInterval = reader.getDouble();
+    double remaining = reader.getDouble();
+    if (remaining >= 0) {
+        if (wakeMsg == nullptr)
+            wakeMsg = new cMessage("wake");
+        scheduleAt(simTime() + remaining, wakeMsg);
+    }
+    numSamplesSent = reader.getLong();
+    remaining = reader.getDouble();
+    if (remaining >= 0) {
+        // The interval may have been set by a command in the original run
+        if (sampleMsg == nullptr)
+            sampleMsg = new cMessage("sample");
+        scheduleAt(simTime() + remaining, sampleMsg);
+    }
+    signal->loadState(reader);
+    signalBlock = reader.getDoubles();
+    signalPos = 0;
+    if (dutyCycling) {
+        cycleAsleep = reader.getBool();
+        superframeInterval = reader.getDouble();
+        activePeriod = reader.getDouble();
+        remaining = reader.getDouble();
+        if (remaining >= 0)
+            scheduleAt(simTime() + remaining, superframeMsg);
+        nextSampleTime = simTime() + reader.getDouble();
+        numBeaconsReceived = reader.getLong();
+        numPacketsMissedAsleep = reader.getLong();
+    }
+}
 
-    int nodeId;
-    double predictedNumber;
-    std::vector<int> receivedValues;
-    int windowSize = 5;
+void SensorNode::finish()
+{
+    energy.recordScalars(this, SIMTIME_DBL(simTime()));
+    if (txQueue != nullptr)
+        txQueue->recordScalars(this, SIMTIME_DBL(simTime()));
+    if (arqSender != nullptr)
+        arqSender->recordScalars(this);
+    if (numCommandsReceived > 0) {
+        recordScalar("commandsReceived", numCommandsReceived);
+        recordScalar("commandLatency:mean", commandLatencySum / numCommandsReceived, "s");
+    }
+    if (dutyCycling) {
+        recordScalar("beaconsReceived", numBeaconsReceived);
+        recordScalar("packetsMissedAsleep", numPacketsMissedAsleep);
+    }
+}
 
+class node11 : public SensorNode
+{
 public:
-    node32(int id = 0) : nodeId(id), predictedNumber(0) {}
+    node11() : SensorNode("Node11", 220, "") {}
 };
 
-Define_Module(node32);
+Define_Module(node11);
 
-void node32::initialize()
+class node12 : public SensorNode
 {
-    // Get the nodeId parameter from the parent module
-        nodeId = par("nodeId");
-
-
-    // Initialize the node
-    EV << "Node32 " << nodeId << " initialized\n";
+public:
+    node12() : SensorNode("Node12", 220, "") {}
+};
 
-    // Start transmitting messages
-    transmitMessage();
-}
+Define_Module(node12);
 
-void node32::handleMessage(cMessage *msg)
+class node21 : public SensorNode
 {
-    // Handle incoming messages
-    EV << "Node32 " << nodeId << " received a message: " << msg->getName() << "\n";
+public:
+    node21() : SensorNode("Node21", 220, " to Hub_node2") {}
+};
 
-    // Delete the message after processing
-    delete msg;
-}
+Define_Module(node21);
 
-void node32::transmitMessage()
+class node22 : public SensorNode
 {
-    for (int i = 0; i < 100; ++i) {
-        // Generate random input values within the specified range
-        int randomValue = intuniform(0, 3000);
-        receivedValues.push_back(randomValue);
+public:
+    node22() : SensorNode("Node22", 200, " to Hub_node2") {}
+};
 
-        // Keep the window size limited
-        if (receivedValues.size() > windowSize) {
-            receivedValues.erase(receivedValues.begin());
-        }
+Define_Module(node22);
 
-        // Calculate the predicted number using moving average
-        double sum = 0;
-        for (int value : receivedValues) {
-            sum += value;
-        }
-        predictedNumber = sum / receivedValues.size();
+class node31 : public SensorNode
+{
+public:
+    node31() : SensorNode("Node31", 200, " to Hub_node3") {}
+};
 
-        // Create and send the message to Hub_node3
-        char msgname[20];
-        sprintf(msgname, "%d", randomValue);
-        cMessage *msg = new cMessage(msgname);
+Define_Module(node31);
 
-        // Log message transmission
-        EV << "Node32 " << nodeId << " generating value: " << randomValue << "\n";
-        EV << "Node32 " << nodeId << " transmitting message: " << msg->getName() << " to Hub_node3\n";
+class node32 : public SensorNode
+{
+public:
+    node32() : SensorNode("Node32", 3000, " to Hub_node3") {}
+};
 
-        send(msg, "output_gate", 0);
-    }
-}
+Define_Module(node32);
@@ -0,0 +1,110 @@
+/*
+ * SimpleKalmanFilterTest.cc
+ *
+ *  Created on: Aug 26, 2024
+ *      Author: pramita
+ */
+
+// Unit test of SimpleKalmanFilter against values worked out by hand from
+//   K = E / (E + M),  x' = x + K (z - x),  E' = (1 - K) E + |x - x'| q
+// with M the measurement error, E the estimate error and q the process noise.
+//
+// usage: SimpleKalmanFilterTest
+
+#include <stdio.h>
+#include <cmath>
+
+#include "../src/SimpleKalmanFilter.h"
+
+static int failures = 0;
+
+// The filter computes in float, so hand-computed values match to about 1e-6
+#define CHECK_NEAR(actual, expected, tolerance) checkNear(actual, expected, tolerance, #actual, __LINE__)
+
+static void checkNear(double actual, double expected, double tolerance, const char *expr, int line) {
+    if (std::fabs(actual - expected) <= tolerance)
+        return;
+    fprintf(stderr, "SimpleKalmanFilterTest.cc:%d: %s is %.9g, expected %.9g\n", line, expr, actual, expected);
+    failures++;
+}
+
+static void testInitialState() {
+    SimpleKalmanFilter kf(2.0, 2.0, 0.01);
+    CHECK_NEAR(kf.getKalmanGain(), 0, 0);
+    CHECK_NEAR(kf.getEstimateError(), 2.0, 0);
+}
+
+static void testFirstSteps() {
+    // Filter of Node_11, starting from an estimate of 0
+    SimpleKalmanFilter kf(2.0, 2.0, 0.01);
+
+    // K = 2 / 4, x = 0 + 0.5 * 10, E = 0.5 * 2 + 5 * 0.01
+    CHECK_NEAR(kf.updateEstimate(10), 5.0, 1e-6);
+    CHECK_NEAR(kf.getKalmanGain(), 0.5, 1e-6);
+    CHECK_NEAR(kf.getEstimateError(), 1.05, 1e-6);
+
+    // K = 1.05 / 3.05, x = 5 + K * 5, E = (1 - K) * 1.05 + (x - 5) * 0.01
+    CHECK_NEAR(kf.updateEstimate(10), 6.7213115, 1e-5);
+    CHECK_NEAR(kf.getKalmanGain(), 0.3442623, 1e-6);
+    CHECK_NEAR(kf.getEstimateError(), 0.7057377, 1e-6);
+
+    // K = 0.7057377 / 2.7057377, x = 6.7213115 + K * 3.2786885
+    CHECK_NEAR(kf.updateEstimate(10), 7.5764923, 1e-5);
+    CHECK_NEAR(kf.getKalmanGain(), 0.2608301, 1e-6);
+    CHECK_NEAR(kf.getEstimateError(), 0.5302119, 1e-6);
+}
+
+static void testConvergence() {
+    // On a constant input the gain and the estimate error fall roughly as
+    // 1/n and the estimate approaches the input from below
+    SimpleKalmanFilter kf(2.0, 2.0, 0.01);
+    double lastEstimate = 0, lastGain = 1, lastError = 2;
+    for (int i = 0; i < 1000; i++) {
+        double estimate = kf.updateEstimate(10);
+        if (!(estimate > lastEstimate && estimate < 10 && kf.getKalmanGain() < lastGain && kf.getEstimateError() < lastError)) {
+            fprintf(stderr, "SimpleKalmanFilterTest.cc: step %d is not converging: estimate %.9g, gain %.9g, error %.9g\n",
+                    i + 1, estimate, kf.getKalmanGain(), kf.getEstimateError());
+            failures++;
+            return;
+        }
+        lastEstimate = estimate;
+        lastGain = kf.getKalmanGain();
+        lastError = kf.getEstimateError();
+    }
+    CHECK_NEAR(lastEstimate, 10, 0.01);
+    CHECK_NEAR(lastGain, 0.001, 0.0001);
+    CHECK_NEAR(lastError, 0.002, 0.0002);
+}
+
+static void testProcessNoise() {
+    // Two equal filters; after the first step one of them gets q = 1
+    SimpleKalmanFilter kf(2.0, 2.0, 0.01);
+    SimpleKalmanFilter noisy(2.0, 2.0, 0.01);
+    kf.updateEstimate(10);
+    noisy.updateEstimate(10);
+    noisy.setProcessNoise(1.0);
+
+    // Same gain and estimate, but E = 0.6885246 + 1.7213115 * q
+    CHECK_NEAR(noisy.updateEstimate(10), kf.updateEstimate(10), 0);
+    CHECK_NEAR(kf.getEstimateError(), 0.7057377, 1e-6);
+    CHECK_NEAR(noisy.getEstimateError(), 2.4098361, 1e-6);
+
+    // The larger estimate error makes the noisy filter follow a jump faster
+    kf.updateEstimate(20);
+    noisy.updateEstimate(20);
+    CHECK_NEAR(kf.getKalmanGain(), 0.2608301, 1e-6);
+    CHECK_NEAR(noisy.getKalmanGain(), 0.5464684, 1e-6);
+}
+
+int main() {
+    testInitialState();
+    testFirstSteps();
+    testConvergence();
+    testProcessNoise();
+    if (failures > 0) {
+        printf("SimpleKalmanFilterTest: %d checks FAILED\n", failures);
+        return 1;
+    }
+    printf("SimpleKalmanFilterTest passed\n");
+    return 0;
+}